@@ -118,6 +118,14 @@ namespace dxilutil {
     llvm::LLVMContext &Ctx, std::string &DiagStr);
   std::unique_ptr<llvm::Module> LoadModuleFromBitcode(llvm::MemoryBuffer *MB,
     llvm::LLVMContext &Ctx, std::string &DiagStr);
+  // Lazy variants only read the module-level records (globals, function
+  // declarations and metadata); function bodies are materialized on demand.
+  // The StringRef overload does not copy BC, which must outlive the module.
+  std::unique_ptr<llvm::Module> LoadModuleFromBitcodeLazy(llvm::StringRef BC,
+    llvm::LLVMContext &Ctx, std::string &DiagStr);
+  std::unique_ptr<llvm::Module> LoadModuleFromBitcodeLazy(
+    std::unique_ptr<llvm::MemoryBuffer> &&MB, llvm::LLVMContext &Ctx,
+    std::string &DiagStr);
   void PrintDiagnosticHandler(const llvm::DiagnosticInfo &DI, void *Context);
   bool IsIntegerOrFloatingPointType(llvm::Type *Ty);
   // Returns true if type contains HLSL Object type (resource)
@@ -11,6 +11,9 @@
 
 #pragma once
 #include "dxc/DXIL/DxilConstants.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
 
 namespace hlsl {
 namespace RDAT {
@@ -140,6 +143,73 @@ public:
     (void)m_size; // avoid unused private warning if use above is ignored.
     return m_table + offset;
   }
+  // Like Get, but returns nullptr when there is no table, the offset is out
+  // of range, or the table is not null terminated.
+  const char *TryGet(uint32_t offset) const {
+    if (!m_table || offset >= m_size || m_table[m_size - 1] != '\0')
+      return nullptr;
+    return m_table + offset;
+  }
+};
+
+// Row indices of a table sorted by name, so rows can be found by name with a
+// binary search. The index is built by the first lookup after the table is
+// set, so loading RDAT does not pay for it. Like the rest of the readers it is
+// not synchronized; the first lookup must not race with other lookups.
+//
+// getName returns nullptr for a row whose name cannot be read, such as a
+// name offset outside the string table. Such a table is not indexed, and
+// lookups scan it, skipping those rows.
+class NameIndex {
+  mutable std::vector<uint32_t> m_rows;
+  mutable bool m_built;
+
+  template <typename GetNameFn>
+  void Build(uint32_t count, GetNameFn getName) const {
+    m_built = true;
+    m_rows.clear();
+    for (uint32_t i = 0; i < count; ++i)
+      if (!getName(i))
+        return;
+    m_rows.resize(count);
+    for (uint32_t i = 0; i < count; ++i)
+      m_rows[i] = i;
+    // Stable, so the first of several rows with one name is found, as with
+    // the linear scan.
+    std::stable_sort(m_rows.begin(), m_rows.end(),
+                     [&](uint32_t a, uint32_t b) {
+                       return strcmp(getName(a), getName(b)) < 0;
+                     });
+  }
+
+public:
+  NameIndex() : m_built(false) {}
+  void Clear() {
+    m_rows.clear();
+    m_built = false;
+  }
+
+  // Returns the row with the given name, or count if there is none.
+  template <typename GetNameFn>
+  uint32_t Find(const char *name, uint32_t count, GetNameFn getName) const {
+    if (!m_built)
+      Build(count, getName);
+    if (m_rows.size() != count) {
+      for (uint32_t i = 0; i < count; ++i) {
+        const char *rowName = getName(i);
+        if (rowName && strcmp(rowName, name) == 0)
+          return i;
+      }
+      return count;
+    }
+    auto it = std::lower_bound(m_rows.begin(), m_rows.end(), name,
+                               [&](uint32_t row, const char *n) {
+                                 return strcmp(getName(row), n) < 0;
+                               });
+    if (it != m_rows.end() && strcmp(getName(*it), name) == 0)
+      return *it;
+    return count;
+  }
 };
 
 enum class DxilResourceFlag : uint32_t {
@@ -446,6 +516,7 @@ class FunctionTableReader {
 private:
   TableReader m_Table;
   RuntimeDataContext *m_Context;
+  NameIndex m_NameIndex;
 
 public:
   FunctionTableReader() : m_Context(nullptr) {}
@@ -455,8 +526,21 @@ public:
   }
   uint32_t GetNumFunctions() const { return m_Table.Count(); }
 
+  // Returns the index of the function with the given (mangled) name, or
+  // GetNumFunctions() if there is none.
+  uint32_t FindFunction(const char *name) const {
+    return m_NameIndex.Find(name, GetNumFunctions(), [this](uint32_t i) {
+      const RuntimeDataFunctionInfo *info =
+          m_Table.Row<RuntimeDataFunctionInfo>(i);
+      return info && m_Context && m_Context->pStringTableReader
+                 ? m_Context->pStringTableReader->TryGet(info->Name)
+                 : nullptr;
+    });
+  }
+
   void SetFunctionInfo(const char *ptr, uint32_t count, uint32_t recordStride) {
     m_Table.Init(ptr, count, recordStride);
+    m_NameIndex.Clear();
   }
   void SetContext(RuntimeDataContext *context) { m_Context = context; }
 };
@@ -573,6 +657,7 @@ class SubobjectTableReader {
 private:
   TableReader m_Table;
   RuntimeDataContext *m_Context;
+  NameIndex m_NameIndex;
 
 public:
   SubobjectTableReader() : m_Context(nullptr) {}
@@ -580,12 +665,25 @@ public:
   void SetContext(RuntimeDataContext *context) { m_Context = context; }
   void SetSubobjectInfo(const char *ptr, uint32_t count, uint32_t recordStride) {
     m_Table.Init(ptr, count, recordStride);
+    m_NameIndex.Clear();
   }
 
   uint32_t GetCount() const { return m_Table.Count(); }
   SubobjectReader GetItem(uint32_t i) const {
     return SubobjectReader(m_Table.Row<RuntimeDataSubobjectInfo>(i), m_Context);
   }
+
+  // Returns the index of the subobject with the given name, or GetCount() if
+  // there is none.
+  uint32_t FindSubobject(const char *name) const {
+    return m_NameIndex.Find(name, GetCount(), [this](uint32_t i) {
+      const RuntimeDataSubobjectInfo *info =
+          m_Table.Row<RuntimeDataSubobjectInfo>(i);
+      return info && m_Context && m_Context->pStringTableReader
+                 ? m_Context->pStringTableReader->TryGet(info->Name)
+                 : nullptr;
+    });
+  }
 };
 
 class DxilRuntimeData {
@@ -0,0 +1,277 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// DxilPIXDebugTrace.h                                                       //
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+// This file is distributed under the University of Illinois Open Source     //
+// License. See LICENSE.TXT for details.                                     //
+//                                                                           //
+// Declares the records written by the PIX debug instrumentation pass, and   //
+// an encoder/decoder for the compact trace format.                          //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pix_dxil {
+
+// These definitions echo those in the debugger application's
+// debugshaderrecord.h file
+enum DebugShaderModifierRecordType {
+  DebugShaderModifierRecordTypeInvocationStartMarker,
+  DebugShaderModifierRecordTypeStep,
+  DebugShaderModifierRecordTypeEvent,
+  DebugShaderModifierRecordTypeInputRegister,
+  DebugShaderModifierRecordTypeReadRegister,
+  DebugShaderModifierRecordTypeWrittenRegister,
+  DebugShaderModifierRecordTypeRegisterRelativeIndex0,
+  DebugShaderModifierRecordTypeRegisterRelativeIndex1,
+  DebugShaderModifierRecordTypeRegisterRelativeIndex2,
+  DebugShaderModifierRecordTypeDXILStepBlock = 250,
+  DebugShaderModifierRecordTypeDXILStepVoid = 251,
+  DebugShaderModifierRecordTypeDXILStepFloat = 252,
+  DebugShaderModifierRecordTypeDXILStepUint32 = 253,
+  DebugShaderModifierRecordTypeDXILStepUint64 = 254,
+  DebugShaderModifierRecordTypeDXILStepDouble = 255,
+};
+
+// These structs echo those in the debugger application's debugshaderrecord.h
+// file, but are recapitulated here because the originals use unnamed unions
+// which are disallowed by DXCompiler's build.
+//
+#pragma pack(push, 4)
+struct DebugShaderModifierRecordHeader {
+  union {
+    struct {
+      uint32_t SizeDwords : 4;
+      uint32_t Flags : 4;
+      uint32_t Type : 8;
+      uint32_t HeaderPayload : 16;
+    } Details;
+    uint32_t u32Header;
+  } Header;
+  uint32_t UID;
+};
+
+struct DebugShaderModifierRecordDXILStepBase {
+  union {
+    struct {
+      uint32_t SizeDwords : 4;
+      uint32_t Flags : 4;
+      uint32_t Type : 8;
+      uint32_t Opcode : 16;
+    } Details;
+    uint32_t u32Header;
+  } Header;
+  uint32_t UID;
+  uint32_t InstructionOffset;
+};
+
+template <typename ReturnType>
+struct DebugShaderModifierRecordDXILStep
+    : public DebugShaderModifierRecordDXILStepBase {
+  ReturnType ReturnValue;
+  union {
+    struct {
+      uint32_t ValueOrdinalBase : 16;
+      uint32_t ValueOrdinalIndex : 16;
+    } Details;
+    uint32_t u32ValueOrdinal;
+  } ValueOrdinal;
+};
+
+template <>
+struct DebugShaderModifierRecordDXILStep<void>
+    : public DebugShaderModifierRecordDXILStepBase {};
+
+// The compact trace format replaces runs of DXILStep records from the same
+// basic block with a single DXILStepBlock record. The block record starts
+// with a DebugShaderModifierRecordHeader whose HeaderPayload holds the number
+// of dwords that follow the UID. The payload is a sequence of compact steps,
+// each of which is one DebugShaderModifierRecordDXILCompactStep word followed
+// by the step's return value and value ordinal, if the step type has them.
+// The header and invocation UID are thereby shared by all the steps in the
+// block, and the instruction offset is folded into the step word.
+struct DebugShaderModifierRecordDXILCompactStep {
+  union {
+    struct {
+      uint32_t InstructionOffset : 24;
+      uint32_t Type : 8;
+    } Details;
+    uint32_t u32Header;
+  } Header;
+};
+#pragma pack(pop)
+
+static constexpr uint32_t DebugShaderModifierRecordDXILCompactStepMaxOffset =
+    (1u << 24) - 1;
+
+inline uint32_t
+DebugShaderModifierRecordPayloadSizeDwords(size_t recordTotalSizeBytes) {
+  return static_cast<uint32_t>(
+      (recordTotalSizeBytes - sizeof(DebugShaderModifierRecordHeader)) /
+      sizeof(uint32_t));
+}
+
+// Returns the number of dwords of return value carried by a DXILStep record
+// of the given type, or -1 if the type is not a DXILStep type.
+inline int DebugShaderModifierRecordDXILStepValueDwords(uint32_t Type) {
+  switch (Type) {
+  case DebugShaderModifierRecordTypeDXILStepVoid:
+    return 0;
+  case DebugShaderModifierRecordTypeDXILStepFloat:
+  case DebugShaderModifierRecordTypeDXILStepUint32:
+    return 1;
+  case DebugShaderModifierRecordTypeDXILStepUint64:
+  case DebugShaderModifierRecordTypeDXILStepDouble:
+    return 2;
+  default:
+    return -1;
+  }
+}
+
+// Returns the size in dwords of the compact encoding of a step of the given
+// type: the step word, plus the return value and value ordinal, if any.
+inline uint32_t DebugShaderModifierRecordDXILCompactStepSizeDwords(
+    uint32_t Type) {
+  int ValueDwords = DebugShaderModifierRecordDXILStepValueDwords(Type);
+  return ValueDwords > 0 ? 1 + ValueDwords + 1 : 1;
+}
+
+// Expands a stream of records that may contain DXILStepBlock records into the
+// equivalent stream of standard records, as written without the compact
+// trace option. Records other than step blocks are copied unchanged. Returns
+// false if the stream is malformed; Out then holds the records decoded so far.
+inline bool DecodeDebugShaderModifierRecords(const uint32_t *pRecords,
+                                             size_t SizeInDwords,
+                                             std::vector<uint32_t> &Out) {
+  const uint32_t *pEnd = pRecords + SizeInDwords;
+  while (pRecords < pEnd) {
+    if (pEnd - pRecords < 2)
+      return false;
+    DebugShaderModifierRecordHeader Header;
+    Header.Header.u32Header = pRecords[0];
+    Header.UID = pRecords[1];
+
+    if (Header.Header.Details.Type !=
+        DebugShaderModifierRecordTypeDXILStepBlock) {
+      size_t RecordDwords = 2 + Header.Header.Details.SizeDwords;
+      if ((size_t)(pEnd - pRecords) < RecordDwords)
+        return false;
+      Out.insert(Out.end(), pRecords, pRecords + RecordDwords);
+      pRecords += RecordDwords;
+      continue;
+    }
+
+    const uint32_t *pStep = pRecords + 2;
+    const uint32_t *pBlockEnd = pStep + Header.Header.Details.HeaderPayload;
+    if (pBlockEnd > pEnd)
+      return false;
+    while (pStep < pBlockEnd) {
+      DebugShaderModifierRecordDXILCompactStep Compact;
+      Compact.Header.u32Header = *pStep;
+      const uint32_t Type = Compact.Header.Details.Type;
+      const int ValueDwords = DebugShaderModifierRecordDXILStepValueDwords(Type);
+      if (ValueDwords < 0)
+        return false;
+      const uint32_t CompactDwords =
+          DebugShaderModifierRecordDXILCompactStepSizeDwords(Type);
+      if ((size_t)(pBlockEnd - pStep) < CompactDwords)
+        return false;
+
+      DebugShaderModifierRecordDXILStepBase Step = {};
+      Step.Header.Details.SizeDwords = DebugShaderModifierRecordPayloadSizeDwords(
+          sizeof(DebugShaderModifierRecordDXILStepBase) +
+          (CompactDwords - 1) * sizeof(uint32_t));
+      Step.Header.Details.Type = Type;
+      Step.UID = Header.UID;
+      Step.InstructionOffset = Compact.Header.Details.InstructionOffset;
+      Out.push_back(Step.Header.u32Header);
+      Out.push_back(Step.UID);
+      Out.push_back(Step.InstructionOffset);
+      Out.insert(Out.end(), pStep + 1, pStep + CompactDwords);
+      pStep += CompactDwords;
+    }
+    pRecords = pBlockEnd;
+  }
+  return true;
+}
+
+// Re-encodes a stream of standard records in the compact format, grouping
+// consecutive DXILStep records of the same invocation into step blocks. The
+// instrumentation only ever groups steps from one basic block, so this
+// produces at most as many blocks as the instrumented shader would. Returns
+// false if the stream is malformed or cannot be represented compactly.
+inline bool EncodeDebugShaderModifierRecords(const uint32_t *pRecords,
+                                             size_t SizeInDwords,
+                                             std::vector<uint32_t> &Out) {
+  const uint32_t *pEnd = pRecords + SizeInDwords;
+  size_t BlockHeaderIndex = 0;
+  bool InBlock = false;
+  uint32_t BlockUID = 0;
+  auto CloseBlock = [&]() {
+    if (InBlock) {
+      DebugShaderModifierRecordHeader BlockHeader = {};
+      BlockHeader.Header.Details.Type =
+          DebugShaderModifierRecordTypeDXILStepBlock;
+      BlockHeader.Header.Details.HeaderPayload =
+          static_cast<uint32_t>(Out.size() - BlockHeaderIndex - 2);
+      Out[BlockHeaderIndex] = BlockHeader.Header.u32Header;
+      InBlock = false;
+    }
+  };
+
+  while (pRecords < pEnd) {
+    if (pEnd - pRecords < 2)
+      return false;
+    DebugShaderModifierRecordHeader Header;
+    Header.Header.u32Header = pRecords[0];
+    Header.UID = pRecords[1];
+    const size_t RecordDwords = 2 + Header.Header.Details.SizeDwords;
+    if ((size_t)(pEnd - pRecords) < RecordDwords)
+      return false;
+
+    const uint32_t Type = Header.Header.Details.Type;
+    const int ValueDwords = DebugShaderModifierRecordDXILStepValueDwords(Type);
+    if (ValueDwords < 0) {
+      CloseBlock();
+      Out.insert(Out.end(), pRecords, pRecords + RecordDwords);
+      pRecords += RecordDwords;
+      continue;
+    }
+
+    const uint32_t InstructionOffset = pRecords[2];
+    const uint32_t CompactDwords =
+        DebugShaderModifierRecordDXILCompactStepSizeDwords(Type);
+    if (RecordDwords != 2 + CompactDwords ||
+        InstructionOffset > DebugShaderModifierRecordDXILCompactStepMaxOffset)
+      return false;
+
+    if (InBlock && (BlockUID != Header.UID ||
+                    Out.size() - BlockHeaderIndex - 2 + CompactDwords >
+                        0xFFFF)) {
+      CloseBlock();
+    }
+    if (!InBlock) {
+      BlockHeaderIndex = Out.size();
+      BlockUID = Header.UID;
+      Out.push_back(0);
+      Out.push_back(BlockUID);
+      InBlock = true;
+    }
+
+    DebugShaderModifierRecordDXILCompactStep Compact = {};
+    Compact.Header.Details.InstructionOffset = InstructionOffset;
+    Compact.Header.Details.Type = Type;
+    Out.push_back(Compact.Header.u32Header);
+    Out.insert(Out.end(), pRecords + 3, pRecords + RecordDwords);
+    pRecords += RecordDwords;
+  }
+  CloseBlock();
+  return true;
+}
+
+} // namespace pix_dxil
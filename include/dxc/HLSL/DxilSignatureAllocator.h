@@ -120,6 +120,9 @@ public:
     ConflictType DetectRowConflict(uint8_t flags, uint8_t indexFlags, DXIL::InterpolationMode interp, unsigned width, DXIL::SignatureDataWidth dataWidth);
     ConflictType DetectColConflict(uint8_t flags, unsigned col, unsigned width);
     void PlaceElement(uint8_t flags, uint8_t indexFlags, DXIL::InterpolationMode interp, unsigned col, unsigned width, DXIL::SignatureDataWidth dataWidth);
+    bool IsFull() const {
+      return (Flags[0] & Flags[1] & Flags[2] & Flags[3] & kEFOccupied) != 0;
+    }
   };
 
   DxilSignatureAllocator(unsigned numRegisters, bool useMinPrecision);
@@ -150,6 +153,8 @@ public:
 
 protected:
   std::vector<PackedRegister> m_Registers;
+  // All rows before this one are full, so searches for space start here.
+  unsigned m_FirstNonFullRow;
   bool m_bIgnoreIndexing;
   bool m_bUseMinPrecision;
 };
@@ -151,7 +151,8 @@ void DxilSignatureAllocator::PackedRegister::PlaceElement(
 }
 
 DxilSignatureAllocator::DxilSignatureAllocator(unsigned numRegisters, bool useMinPrecision)
-  : m_bIgnoreIndexing(false), m_bUseMinPrecision(useMinPrecision) {
+  : m_FirstNonFullRow(0), m_bIgnoreIndexing(false),
+    m_bUseMinPrecision(useMinPrecision) {
   m_Registers.resize(numRegisters);
 }
 
@@ -193,6 +194,9 @@ void DxilSignatureAllocator::PlaceElement(const PackElement *SE, unsigned row, u
     uint8_t indexFlags = m_bIgnoreIndexing ? 0 : GetIndexFlags(i, rows);
     m_Registers[row + i].PlaceElement(flags, indexFlags, interp, col, cols, SE->GetDataBitWidth());
   }
+  while (m_FirstNonFullRow < m_Registers.size() &&
+         m_Registers[m_FirstNonFullRow].IsFull())
+    ++m_FirstNonFullRow;
 }
 
 
@@ -238,7 +242,13 @@ unsigned DxilSignatureAllocator::FindNext(
   unsigned cols = SE->GetCols();
   DXASSERT_NOMSG(startCol + cols <= 4);
 
-  for (unsigned row = startRow; row <= (startRow + numRows - rows); ++row) {
+  // Full rows always conflict, so skip those known to be full. Greedy packing
+  // fills rows in order, which otherwise makes this search quadratic.
+  unsigned firstRow = startRow;
+  if (rows && cols)
+    firstRow = std::max(firstRow, m_FirstNonFullRow);
+
+  for (unsigned row = firstRow; row <= (startRow + numRows - rows); ++row) {
     if (DetectRowConflict(SE, row))
       continue;
     for (unsigned col = startCol; col <= 4 - cols; ++col) {
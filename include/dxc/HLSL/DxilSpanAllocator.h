@@ -52,13 +52,33 @@ public:
       return false;
     if (pos < m_FirstFree)
       pos = m_FirstFree;
+
+    // Unaligned searches that start at or before the last gap found for this
+    // size resume from there, since spans are never removed and nothing
+    // before that gap can fit.
+    bool updateHint = false;
+    if (align <= 1) {
+      auto hint = m_FindHints.find(size);
+      T_index known = m_FirstFree;
+      if (hint != m_FindHints.end() && known < hint->second)
+        known = hint->second;
+      if (pos <= known) {
+        pos = known;
+        updateHint = true;
+      }
+    }
+
     if (!UpdatePos(pos, size, align))
       return false;
     T_index end = pos + (size - 1);
     auto next = m_Spans.lower_bound(Span(nullptr, pos, end));
-    if (next == m_Spans.end() || end < next->start)
-      return true;  // it fits here
-    return Find(size, next, pos, align);
+    if (next != m_Spans.end() && !(end < next->start)) {
+      if (!Find(size, next, pos, align))
+        return false;
+    }
+    if (updateHint)
+      m_FindHints[size] = pos;
+    return true;
   }
 
   // Finds the farthest position at which an element could be allocated.
@@ -195,6 +215,8 @@ private:
 
 private:
   SpanSet m_Spans;
+  // Position of the first gap found by Find for each size, with no alignment.
+  std::map<T_index, T_index> m_FindHints;
   T_index m_Min, m_Max, m_FirstFree;
   const T_element *m_Unbounded;
   bool m_AllocationFull;
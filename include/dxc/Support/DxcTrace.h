@@ -0,0 +1,48 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// DxcTrace.h                                                                //
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+// This file is distributed under the University of Illinois Open Source     //
+// License. See LICENSE.TXT for details.                                     //
+//                                                                           //
+// Provides a portable tracing backend for compiler events.                  //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+namespace hlsl {
+namespace trace {
+
+// Events are written in the Chrome trace event format to a file named by the
+// DXC_TRACE_FILE environment variable, which is read once per process. Each
+// process writes its own file, named by appending ".<pid>" to that value, so
+// concurrent compiler processes never overwrite each other's traces.
+// When it is not set, tracing is disabled and an event costs a single test.
+// On platforms without ETW, the DxcEtw_* events are routed here as well.
+bool IsEnabled();
+void BeginEvent(const char *pName);
+void EndEvent(const char *pName);
+void EndEvent(const char *pName, long hr);
+
+// Traces the lifetime of a scope as a single span.
+class ScopedEvent {
+private:
+  const char *m_pName; // nullptr when tracing is disabled.
+
+public:
+  explicit ScopedEvent(const char *pName)
+      : m_pName(IsEnabled() ? pName : nullptr) {
+    if (m_pName)
+      BeginEvent(m_pName);
+  }
+  ~ScopedEvent() {
+    if (m_pName)
+      EndEvent(m_pName);
+  }
+  ScopedEvent(const ScopedEvent &) = delete;
+  ScopedEvent &operator=(const ScopedEvent &) = delete;
+};
+
+} // namespace trace
+} // namespace hlsl
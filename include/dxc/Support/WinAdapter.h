@@ -18,6 +18,7 @@
 #ifndef _WIN32
 
 #ifdef __cplusplus
+#include "dxc/Support/DxcTrace.h"
 #include <atomic>
 #include <cassert>
 #include <climits>
@@ -211,17 +212,40 @@
 
 // Event Tracing for Windows (ETW) provides application programmers the ability
 // to start and stop event tracing sessions, instrument an application to
-// provide trace events, and consume trace events.
-#define DxcEtw_DXCompilerCreateInstance_Start()
-#define DxcEtw_DXCompilerCreateInstance_Stop(hr)
-#define DxcEtw_DXCompilerCompile_Start()
-#define DxcEtw_DXCompilerCompile_Stop(hr)
-#define DxcEtw_DXCompilerDisassemble_Start()
-#define DxcEtw_DXCompilerDisassemble_Stop(hr)
-#define DxcEtw_DXCompilerPreprocess_Start()
-#define DxcEtw_DXCompilerPreprocess_Stop(hr)
-#define DxcEtw_DxcValidation_Start()
-#define DxcEtw_DxcValidation_Stop(hr)
+// provide trace events, and consume trace events. Elsewhere, the events from
+// dxcetw.man go to the portable backend in DxcTrace.h.
+#define DXC_TRACE_EVENT_START(Task) ::hlsl::trace::BeginEvent(#Task)
+#define DXC_TRACE_EVENT_STOP(Task, hr) ::hlsl::trace::EndEvent(#Task, (hr))
+#define DxcEtw_DXCompilerInitialization_Start()                                \
+  DXC_TRACE_EVENT_START(DXCompilerInitialization)
+#define DxcEtw_DXCompilerInitialization_Stop(hr)                               \
+  DXC_TRACE_EVENT_STOP(DXCompilerInitialization, hr)
+#define DxcEtw_DXCompilerShutdown_Start()                                      \
+  DXC_TRACE_EVENT_START(DXCompilerShutdown)
+#define DxcEtw_DXCompilerShutdown_Stop(hr)                                     \
+  DXC_TRACE_EVENT_STOP(DXCompilerShutdown, hr)
+#define DxcEtw_DXCompilerCreateInstance_Start()                                \
+  DXC_TRACE_EVENT_START(DXCompilerCreateInstance)
+#define DxcEtw_DXCompilerCreateInstance_Stop(hr)                               \
+  DXC_TRACE_EVENT_STOP(DXCompilerCreateInstance, hr)
+#define DxcEtw_DXCompilerIntelliSenseParse_Start()                             \
+  DXC_TRACE_EVENT_START(DXCompilerIntelliSenseParse)
+#define DxcEtw_DXCompilerIntelliSenseParse_Stop(hr)                            \
+  DXC_TRACE_EVENT_STOP(DXCompilerIntelliSenseParse, hr)
+#define DxcEtw_DXCompilerCompile_Start()                                       \
+  DXC_TRACE_EVENT_START(DXCompilerCompile)
+#define DxcEtw_DXCompilerCompile_Stop(hr)                                      \
+  DXC_TRACE_EVENT_STOP(DXCompilerCompile, hr)
+#define DxcEtw_DXCompilerDisassemble_Start()                                   \
+  DXC_TRACE_EVENT_START(DXCompilerDisassemble)
+#define DxcEtw_DXCompilerDisassemble_Stop(hr)                                  \
+  DXC_TRACE_EVENT_STOP(DXCompilerDisassemble, hr)
+#define DxcEtw_DXCompilerPreprocess_Start()                                    \
+  DXC_TRACE_EVENT_START(DXCompilerPreprocess)
+#define DxcEtw_DXCompilerPreprocess_Stop(hr)                                   \
+  DXC_TRACE_EVENT_STOP(DXCompilerPreprocess, hr)
+#define DxcEtw_DxcValidation_Start() DXC_TRACE_EVENT_START(DxcValidation)
+#define DxcEtw_DxcValidation_Stop(hr) DXC_TRACE_EVENT_STOP(DxcValidation, hr)
 
 #define UInt32Add UIntAdd
 #define Int32ToUInt32 IntToUInt
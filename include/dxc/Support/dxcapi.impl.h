@@ -91,6 +91,7 @@ inline DxcOutputType DxcGetOutputType(DXC_OUT_KIND kind) {
   case DXC_OUT_SHADER_HASH:
   case DXC_OUT_REFLECTION:
   case DXC_OUT_ROOT_SIGNATURE:
+  case DXC_OUT_CONTENT_HASH:
     return DxcOutputType_Blob;
   case DXC_OUT_ERRORS:
   case DXC_OUT_DISASSEMBLY:
@@ -102,7 +103,7 @@ inline DxcOutputType DxcGetOutputType(DXC_OUT_KIND kind) {
 }
 
 // Update when new results are allowed
-static const unsigned kNumDxcOutputTypes = DXC_OUT_ROOT_SIGNATURE;
+static const unsigned kNumDxcOutputTypes = DXC_OUT_CONTENT_HASH;
 static const SIZE_T kAutoSize = (SIZE_T)-1;
 static const LPCWSTR DxcOutNoName = nullptr;
 
@@ -120,6 +121,15 @@ struct DxcOutputObject {
     if (!pUnknown)
       return S_OK;
     if (codePage && DxcGetOutputType(kind) == DxcOutputType_Text) {
+      // Text that is already null-terminated in the requested encoding can
+      // be returned as is.
+      CComPtr<IDxcBlobUtf8> pUtf8;
+      CComPtr<IDxcBlobUtf16> pUtf16;
+      if ((codePage == DXC_CP_UTF8 && SUCCEEDED(pUnknown->QueryInterface(&pUtf8))) ||
+          (codePage == DXC_CP_UTF16 && SUCCEEDED(pUnknown->QueryInterface(&pUtf16)))) {
+        object = pUnknown;
+        return S_OK;
+      }
       CComPtr<IDxcBlob> pBlob;
       IFR(pUnknown->QueryInterface(&pBlob));
       CComPtr<IDxcBlobEncoding> pEncoding;
@@ -461,6 +461,7 @@ typedef enum DXC_OUT_KIND {
   DXC_OUT_TEXT = 7,           // IDxcBlobUtf8 or IDxcBlobUtf16 - other text, such as -ast-dump or -Odump
   DXC_OUT_REFLECTION = 8,     // IDxcBlob - RDAT part with reflection data
   DXC_OUT_ROOT_SIGNATURE = 9, // IDxcBlob - Serialized root signature output
+  DXC_OUT_CONTENT_HASH = 10,  // IDxcBlob - 64-bit xxHash of the final container, little-endian (-Fch)
 
   DXC_OUT_FORCE_DWORD = 0xFFFFFFFF
 } DXC_OUT_KIND;
@@ -479,6 +480,11 @@ IDxcResult : public IDxcOperationResult {
   DECLARE_CROSS_PLATFORM_UUIDOF(IDxcResult)
 };
 
+// Compile and Disassemble may be called concurrently on one instance from
+// any number of threads. Configure the instance (IDxcLangExtensions,
+// IDxcContainerEvent) before sharing it; configuration is not synchronized.
+// Concurrent calls allocate through the IMalloc given to DxcCreateInstance2
+// at the same time, so that allocator must be thread-safe.
 struct __declspec(uuid("228B4687-5A6A-4730-900C-9702B2203F54"))
 IDxcCompiler3 : public IUnknown {
   // Compile a single entry point to the target shader model,
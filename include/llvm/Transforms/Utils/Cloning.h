@@ -23,6 +23,7 @@
 #include "llvm/IR/ValueHandle.h"
 #include "llvm/IR/ValueMap.h"
 #include "llvm/Transforms/Utils/ValueMapper.h"
+#include <functional> // HLSL Change
 
 namespace llvm {
 
@@ -51,6 +52,13 @@ class DominatorTree;
 ///
 Module *CloneModule(const Module *M);
 Module *CloneModule(const Module *M, ValueToValueMapTy &VMap);
+// HLSL Change Begin - Allow cloning only the declarations of some functions.
+/// Functions for which ShouldCloneDefinition returns false are cloned as
+/// external declarations, as if deleteBody had been called on the copy.
+Module *
+CloneModule(const Module *M, ValueToValueMapTy &VMap,
+            std::function<bool(const Function *)> ShouldCloneDefinition);
+// HLSL Change End
 
 /// ClonedCodeInfo - This struct can be used to capture information about code
 /// being cloned, while it is being cloned.
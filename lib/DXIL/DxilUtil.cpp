@@ -210,6 +210,25 @@ std::unique_ptr<llvm::Module> LoadModuleFromBitcode(llvm::StringRef BC,
   return LoadModuleFromBitcode(pBitcodeBuf.get(), Ctx, DiagStr);
 }
 
+std::unique_ptr<llvm::Module>
+LoadModuleFromBitcodeLazy(std::unique_ptr<llvm::MemoryBuffer> &&MB,
+  llvm::LLVMContext &Ctx, std::string &DiagStr) {
+  // Note: the DiagStr is not used.
+  auto pModule = llvm::getLazyBitcodeModule(std::move(MB), Ctx);
+  if (!pModule) {
+    return nullptr;
+  }
+  return std::unique_ptr<llvm::Module>(pModule.get().release());
+}
+
+std::unique_ptr<llvm::Module> LoadModuleFromBitcodeLazy(llvm::StringRef BC,
+  llvm::LLVMContext &Ctx,
+  std::string &DiagStr) {
+  std::unique_ptr<llvm::MemoryBuffer> pBitcodeBuf(
+    llvm::MemoryBuffer::getMemBuffer(BC, "", false));
+  return LoadModuleFromBitcodeLazy(std::move(pBitcodeBuf), Ctx, DiagStr);
+}
+
 
 DIGlobalVariable *FindGlobalVariableDebugInfo(GlobalVariable *GV,
                                               DebugInfoFinder &DbgInfoFinder) {
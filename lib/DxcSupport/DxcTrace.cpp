@@ -0,0 +1,115 @@
+///////////////////////////////////////////////////////////////////////////////
+//                                                                           //
+// DxcTrace.cpp                                                              //
+// Copyright (C) Microsoft Corporation. All rights reserved.                 //
+// This file is distributed under the University of Illinois Open Source     //
+// License. See LICENSE.TXT for details.                                     //
+//                                                                           //
+// Provides a portable tracing backend for compiler events.                  //
+//                                                                           //
+///////////////////////////////////////////////////////////////////////////////
+
+#include "dxc/Support/DxcTrace.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+class TraceSink {
+private:
+  FILE *m_pFile;
+  bool m_FirstEvent;
+  int m_ProcessId;
+  std::chrono::steady_clock::time_point m_Start;
+  std::mutex m_Lock;
+
+public:
+  TraceSink()
+      : m_pFile(nullptr), m_FirstEvent(true),
+        m_Start(std::chrono::steady_clock::now()) {
+#ifdef _WIN32
+    m_ProcessId = _getpid();
+#else
+    m_ProcessId = (int)getpid();
+#endif
+    const char *pPath = std::getenv("DXC_TRACE_FILE");
+    if (pPath && *pPath) {
+      std::string Path(pPath);
+      Path += "." + std::to_string(m_ProcessId);
+      m_pFile = std::fopen(Path.c_str(), "w");
+      if (m_pFile)
+        std::fputs("[", m_pFile);
+    }
+  }
+
+  bool IsEnabled() const { return m_pFile != nullptr; }
+
+  void Write(const char *pName, char Phase, const long *pHR) {
+    uint64_t Timestamp =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - m_Start)
+            .count();
+    uint64_t ThreadId = std::hash<std::thread::id>()(std::this_thread::get_id());
+    std::lock_guard<std::mutex> Lock(m_Lock);
+    std::fprintf(m_pFile,
+                 "%s\n{\"name\":\"%s\",\"cat\":\"dxc\",\"ph\":\"%c\","
+                 "\"ts\":%llu,\"pid\":%d,\"tid\":%llu",
+                 m_FirstEvent ? "" : ",", pName, Phase,
+                 (unsigned long long)Timestamp, m_ProcessId,
+                 (unsigned long long)ThreadId);
+    if (pHR)
+      std::fprintf(m_pFile, ",\"args\":{\"hr\":\"0x%08x\"}", (unsigned)*pHR);
+    std::fputs("}", m_pFile);
+    // The trace viewers accept a file without the closing bracket, so
+    // flushing every event keeps the file usable if the process never exits
+    // cleanly.
+    std::fflush(m_pFile);
+    m_FirstEvent = false;
+  }
+};
+
+// Never destroyed, so events from other static destructors and from the
+// library shutdown path are still safe to record.
+TraceSink &GetSink() {
+  static TraceSink *pSink = new TraceSink();
+  return *pSink;
+}
+
+} // namespace
+
+namespace hlsl {
+namespace trace {
+
+bool IsEnabled() { return GetSink().IsEnabled(); }
+
+void BeginEvent(const char *pName) {
+  TraceSink &Sink = GetSink();
+  if (Sink.IsEnabled())
+    Sink.Write(pName, 'B', nullptr);
+}
+
+void EndEvent(const char *pName) {
+  TraceSink &Sink = GetSink();
+  if (Sink.IsEnabled())
+    Sink.Write(pName, 'E', nullptr);
+}
+
+void EndEvent(const char *pName, long hr) {
+  TraceSink &Sink = GetSink();
+  if (Sink.IsEnabled())
+    Sink.Write(pName, 'E', &hr);
+}
+
+} // namespace trace
+} // namespace hlsl
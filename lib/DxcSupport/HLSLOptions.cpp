@@ -464,6 +464,7 @@ int ReadDxcOpts(const OptTable *optionTable, unsigned flagsToInclude,
   opts.OutputReflectionFile = Args.getLastArgValue(OPT_Fre);
   opts.OutputRootSigFile = Args.getLastArgValue(OPT_Frs);
   opts.OutputShaderHashFile = Args.getLastArgValue(OPT_Fsh);
+  opts.OutputContentHashFile = Args.getLastArgValue(OPT_Fch);
   opts.ShowOptionNames = Args.hasFlag(OPT_fdiagnostics_show_option, OPT_fno_diagnostics_show_option, true);
   opts.UseColor = Args.hasFlag(OPT_Cc, OPT_INVALID, false);
   opts.UseInstructionNumbers = Args.hasFlag(OPT_Ni, OPT_INVALID, false);
@@ -651,7 +652,8 @@ int ReadDxcOpts(const OptTable *optionTable, unsigned flagsToInclude,
        !opts.OutputWarnings || !opts.OutputWarningsFile.empty() ||
        !opts.OutputReflectionFile.empty() ||
        !opts.OutputRootSigFile.empty() ||
-       !opts.OutputShaderHashFile.empty())) {
+       !opts.OutputShaderHashFile.empty() ||
+       !opts.OutputContentHashFile.empty())) {
     opts.OutputHeader = "";
     opts.OutputObject = "";
     opts.OutputWarnings = true;
@@ -659,6 +661,7 @@ int ReadDxcOpts(const OptTable *optionTable, unsigned flagsToInclude,
     opts.OutputReflectionFile = "";
     opts.OutputRootSigFile = "";
     opts.OutputShaderHashFile = "";
+    opts.OutputContentHashFile = "";
     errors << "Warning: compiler options ignored with Preprocess.";
   }
 
@@ -1699,17 +1699,15 @@ void hlsl::SerializeDxilContainerForModule(DxilModule *pModule,
     pModule->SetValidatorVersion(0, 0);
     pModule->ReEmitDxilResources();
 
-    reflectionModule.reset(llvm::CloneModule(pModule->GetModule()));
+    // Function bodies are not needed for reflection, so don't clone them.
+    llvm::ValueToValueMapTy VMap;
+    reflectionModule.reset(llvm::CloneModule(
+        pModule->GetModule(), VMap,
+        [](const Function *) { return false; }));
 
     // Now restore validator version on main module and re-emit metadata.
     pModule->SetValidatorVersion(ValMajor, ValMinor);
     pModule->ReEmitDxilResources();
-
-    for (Function &F : reflectionModule->functions()) {
-      if (!F.isDeclaration()) {
-        F.deleteBody();
-      }
-    }
     // Just make sure this doesn't crash/assert on debug build:
     DXASSERT_NOMSG(&reflectionModule->GetOrCreateDxilModule());
   }
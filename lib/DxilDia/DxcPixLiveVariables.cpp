@@ -17,6 +17,7 @@
 #include "DxcPixLiveVariables_FragmentIterator.h" 
 
 #include "dxc/Support/Global.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/IR/DebugInfo.h"
 #include "llvm/IR/DebugInfoMetadata.h"
@@ -62,10 +63,18 @@ struct dxil_debug_info::LiveVariables::Impl
   using LiveVarsMap =
       std::unordered_map<llvm::DIScope*, VariableInfoMap>;
 
+  // The set of live variables only depends on the instruction's scope and
+  // source line, so queries are memoized on that pair. Stepping through a
+  // trace revisits the same few locations over and over.
+  using ScopeAndLine = std::pair<llvm::DIScope *, unsigned>;
+  using LiveVarsAtLocationMap =
+      llvm::DenseMap<ScopeAndLine, std::vector<const VariableInfo *>>;
+
   IMalloc *m_pMalloc;
   DxcPixDxilDebugInfo *m_pDxilDebugInfo;
   llvm::Module *m_pModule;
   LiveVarsMap m_LiveVarsDbgDeclare;
+  LiveVarsAtLocationMap m_LiveVarsAtLocation;
 
   void Init(
       IMalloc *pMalloc,
@@ -80,6 +89,9 @@ struct dxil_debug_info::LiveVariables::Impl
       llvm::Value *Address,
       unsigned FragmentIndex,
       unsigned FragmentOffsetInBits);
+
+  const std::vector<const VariableInfo *> &
+  LiveVariablesAt(llvm::DIScope *S, unsigned Line);
 };
 
 void dxil_debug_info::LiveVariables::Impl::Init(
@@ -206,39 +218,34 @@ void dxil_debug_info::LiveVariables::Clear() {
   m_pImpl.reset(new dxil_debug_info::LiveVariables::Impl());
 }
 
-HRESULT dxil_debug_info::LiveVariables::GetLiveVariablesAtInstruction(
-  llvm::Instruction *IP,
-  IDxcPixDxilLiveVariables **ppResult) const {
-  DXASSERT(IP != nullptr, "else IP should not be nullptr");
-  DXASSERT(ppResult != nullptr, "else Result should not be nullptr");
-
-  std::vector<const VariableInfo *> LiveVars;
-  std::set<std::string> LiveVarsName;
-
-  const llvm::DebugLoc &DL = IP->getDebugLoc();
-
-  if (!DL)
+const std::vector<const dxil_debug_info::VariableInfo *> &
+dxil_debug_info::LiveVariables::Impl::LiveVariablesAt(
+    llvm::DIScope *S,
+    unsigned Line
+)
+{
+  auto Inserted = m_LiveVarsAtLocation.insert(
+      std::make_pair(std::make_pair(S, Line),
+                     std::vector<const VariableInfo *>()));
+  std::vector<const VariableInfo *> &LiveVars = Inserted.first->second;
+  if (!Inserted.second)
   {
-    return E_FAIL;
+    return LiveVars;
   }
 
-  llvm::DIScope *S = DL->getScope();
-  if (S == nullptr)
-  {
-    return E_FAIL;
-  }
+  std::set<std::string> LiveVarsName;
 
   const llvm::DITypeIdentifierMap EmptyMap;
   while (S != nullptr)
   {
-    auto it = m_pImpl->m_LiveVarsDbgDeclare.find(S);
-    if (it != m_pImpl->m_LiveVarsDbgDeclare.end())
+    auto it = m_LiveVarsDbgDeclare.find(S);
+    if (it != m_LiveVarsDbgDeclare.end())
     {
       for (const auto &VarAndInfo :  it->second)
       {
         auto *Var = VarAndInfo.first;
         llvm::StringRef VarName = Var->getName();
-        if (Var->getLine() > DL.getLine())
+        if (Var->getLine() > Line)
         {
           // Defined later in the HLSL source.
           continue;
@@ -261,6 +268,31 @@ HRESULT dxil_debug_info::LiveVariables::GetLiveVariablesAtInstruction(
     S = S->getScope().resolve(EmptyMap);
   }
 
+  return LiveVars;
+}
+
+HRESULT dxil_debug_info::LiveVariables::GetLiveVariablesAtInstruction(
+  llvm::Instruction *IP,
+  IDxcPixDxilLiveVariables **ppResult) const {
+  DXASSERT(IP != nullptr, "else IP should not be nullptr");
+  DXASSERT(ppResult != nullptr, "else Result should not be nullptr");
+
+  const llvm::DebugLoc &DL = IP->getDebugLoc();
+
+  if (!DL)
+  {
+    return E_FAIL;
+  }
+
+  llvm::DIScope *S = DL->getScope();
+  if (S == nullptr)
+  {
+    return E_FAIL;
+  }
+
+  std::vector<const VariableInfo *> LiveVars =
+      m_pImpl->LiveVariablesAt(S, DL.getLine());
+
   return CreateDxilLiveVariables(
       m_pImpl->m_pDxilDebugInfo,
       std::move(LiveVars),
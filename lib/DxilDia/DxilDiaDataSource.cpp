@@ -143,8 +143,8 @@ STDMETHODIMP dxil_dia::DataSource::loadDataFromIStream(_In_ IStream *pInputIStre
       pBitcodeBuffer, *m_context.get(), DiagStr);
     if (!pModule.get())
       return E_FAIL;
+    // The finder is populated on demand by the sessions that need symbols.
     m_finder = std::make_shared<llvm::DebugInfoFinder>();
-    m_finder->processModule(*pModule.get());
     m_module.reset(pModule.release());
   }
   CATCH_CPP_RETURN_HRESULT();
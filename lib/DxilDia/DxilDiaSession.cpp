@@ -100,12 +100,29 @@ void dxil_dia::Session::Init(
     DXASSERT(m_rvaMap[It->second] == It->first, "instruction mapped to wrong rva");
   }
 
-  // Initialize symbols
-  try {
-      m_symsMgr.Init(this);
-  } catch (const hlsl::Exception &) {
-      m_symsMgr = std::move(dxil_dia::SymbolManager());
+  // Symbols are initialized lazily - see SymMgr().
+  m_symsMgrInitialized = false;
+}
+
+llvm::DebugInfoFinder &dxil_dia::Session::InfoRef() {
+  // The data source hands out an unprocessed finder; only sessions that
+  // query symbols pay for walking the debug info.
+  if (m_finder->compile_unit_count() == 0) {
+    m_finder->processModule(*m_module);
+  }
+  return *m_finder.get();
+}
+
+const dxil_dia::SymbolManager &dxil_dia::Session::SymMgr() {
+  if (!m_symsMgrInitialized) {
+    m_symsMgrInitialized = true;
+    try {
+        m_symsMgr.Init(this);
+    } catch (const hlsl::Exception &) {
+        m_symsMgr = std::move(dxil_dia::SymbolManager());
+    }
   }
+  return m_symsMgr;
 }
 
 HRESULT dxil_dia::Session::getSourceFileIdByName(
@@ -142,7 +159,7 @@ STDMETHODIMP dxil_dia::Session::get_globalScope(
   *pRetVal = nullptr;
 
   Symbol *ret;
-  IFR(m_symsMgr.GetGlobalScope(&ret));
+  IFR(SymMgr().GetGlobalScope(&ret));
   *pRetVal = ret;
   return S_OK;
 }
@@ -238,10 +255,12 @@ static HRESULT DxcDiaFindLineNumbersByRVA(
   std::vector<const llvm::Instruction*> instructions;
   auto &allInstructions = pSession->InstructionsRef();
 
-  // Gather the list of insructions that map to the given rva range.
-  for (DWORD i = rva; i < rva + length; ++i) {
-    auto It = allInstructions.find(i);
-    if (It == allInstructions.end())
+  // Gather the list of insructions that map to the given rva range. RVAs are
+  // the keys of an ordered map, so look up the first one and walk forward
+  // rather than searching for every address in the range.
+  auto It = allInstructions.find(rva);
+  for (DWORD i = rva; i < rva + length; ++i, ++It) {
+    if (It == allInstructions.end() || It->first != i)
       return E_INVALIDARG;
 
     // Only include the instruction if it has debug info for line mappings.
@@ -388,7 +407,7 @@ STDMETHODIMP dxil_dia::Session::findInlineFramesByAddr(
 
   HRESULT hr;
   SymbolChildrenEnumerator *ChildrenEnum;
-  IFR(hr = m_symsMgr.DbgScopeOf(It->second, &ChildrenEnum));
+  IFR(hr = SymMgr().DbgScopeOf(It->second, &ChildrenEnum));
 
   *ppResult = ChildrenEnum;
   return hr;
@@ -62,8 +62,8 @@ public:
   llvm::NamedMDNode *Arguments() { return m_arguments; }
   hlsl::DxilModule &DxilModuleRef() { return *m_dxilModule.get(); }
   llvm::Module &ModuleRef() { return *m_module.get(); }
-  llvm::DebugInfoFinder &InfoRef() { return *m_finder.get(); }
-  const SymbolManager &SymMgr() const { return m_symsMgr; }
+  llvm::DebugInfoFinder &InfoRef();
+  const SymbolManager &SymMgr();
   const RVAMap &InstructionsRef() const { return m_instructions; }
   const std::vector<const llvm::Instruction *> &InstructionLinesRef() const { return m_instructionLines; }
   const std::unordered_map<const llvm::Instruction *, RVA> &RvaMapRef() const { return m_rvaMap; }
@@ -396,7 +396,10 @@ private:
   std::vector<const llvm::Instruction *> m_instructionLines; // Instructions with line info.
   std::unordered_map<const llvm::Instruction *, RVA> m_rvaMap; // Map instruction to its RVA.
   LineToInfoMap m_lineToInfoMap;
+  // The symbol tables are only needed by symbol queries, so they are built on
+  // first use rather than when the session is opened.
   SymbolManager m_symsMgr;
+  bool m_symsMgrInitialized = false;
 
 private:
   CComPtr<IDiaEnumTables> m_pEnumTables;
@@ -12,6 +12,7 @@
 #include "dxc/DXIL/DxilModule.h"
 #include "dxc/DXIL/DxilOperations.h"
 #include "dxc/DXIL/DxilUtil.h"
+#include "dxc/DxilPIXPasses/DxilPIXDebugTrace.h"
 #include "dxc/DxilPIXPasses/DxilPIXPasses.h"
 #include "dxc/DxilPIXPasses/DxilPIXVirtualRegisters.h"
 #include "dxc/HLSL/DxilGenerationPass.h"
@@ -24,6 +25,7 @@
 
 using namespace llvm;
 using namespace hlsl;
+using namespace pix_dxil;
 
 // Overview of instrumentation:
 //
@@ -83,85 +85,23 @@ using namespace hlsl;
 // overwritten, the debug session is deemed to have overflowed the UAV. The
 // caller will than allocate a UAV that is twice the size and try again, up to a
 // predefined maximum.
+//
+// When the compactTrace option is set, the steps of each basic block are
+// written as a single DXILStepBlock record instead (see DxilPIXDebugTrace.h).
+// The block's space in the UAV is reserved with one atomic increment at the
+// position of its first step, and each step then writes its compact encoding
+// at a fixed offset from there. This saves the per-step header, invocation id
+// and instruction offset dwords, and most of the atomics. Blocks are split so
+// that no single reservation exceeds CompactTraceMaxBlockSizeInBytes.
 
 // Keep this in sync with the same-named value in the debugger application's
 // WinPixShaderUtils.h
 constexpr uint64_t DebugBufferDumpingGroundSize = 64 * 1024;
 
-// These definitions echo those in the debugger application's
-// debugshaderrecord.h file
-enum DebugShaderModifierRecordType {
-  DebugShaderModifierRecordTypeInvocationStartMarker,
-  DebugShaderModifierRecordTypeStep,
-  DebugShaderModifierRecordTypeEvent,
-  DebugShaderModifierRecordTypeInputRegister,
-  DebugShaderModifierRecordTypeReadRegister,
-  DebugShaderModifierRecordTypeWrittenRegister,
-  DebugShaderModifierRecordTypeRegisterRelativeIndex0,
-  DebugShaderModifierRecordTypeRegisterRelativeIndex1,
-  DebugShaderModifierRecordTypeRegisterRelativeIndex2,
-  DebugShaderModifierRecordTypeDXILStepVoid = 251,
-  DebugShaderModifierRecordTypeDXILStepFloat = 252,
-  DebugShaderModifierRecordTypeDXILStepUint32 = 253,
-  DebugShaderModifierRecordTypeDXILStepUint64 = 254,
-  DebugShaderModifierRecordTypeDXILStepDouble = 255,
-};
-
-// These structs echo those in the debugger application's debugshaderrecord.h
-// file, but are recapitulated here because the originals use unnamed unions
-// which are disallowed by DXCompiler's build.
-//
-#pragma pack(push, 4)
-struct DebugShaderModifierRecordHeader {
-  union {
-    struct {
-      uint32_t SizeDwords : 4;
-      uint32_t Flags : 4;
-      uint32_t Type : 8;
-      uint32_t HeaderPayload : 16;
-    } Details;
-    uint32_t u32Header;
-  } Header;
-  uint32_t UID;
-};
-
-struct DebugShaderModifierRecordDXILStepBase {
-  union {
-    struct {
-      uint32_t SizeDwords : 4;
-      uint32_t Flags : 4;
-      uint32_t Type : 8;
-      uint32_t Opcode : 16;
-    } Details;
-    uint32_t u32Header;
-  } Header;
-  uint32_t UID;
-  uint32_t InstructionOffset;
-};
-
-template <typename ReturnType>
-struct DebugShaderModifierRecordDXILStep
-    : public DebugShaderModifierRecordDXILStepBase {
-  ReturnType ReturnValue;
-  union {
-    struct {
-      uint32_t ValueOrdinalBase : 16;
-      uint32_t ValueOrdinalIndex : 16;
-    } Details;
-    uint32_t u32ValueOrdinal;
-  } ValueOrdinal;
-};
-
-template <>
-struct DebugShaderModifierRecordDXILStep<void>
-    : public DebugShaderModifierRecordDXILStepBase {};
-#pragma pack(pop)
-
-uint32_t
-DebugShaderModifierRecordPayloadSizeDwords(size_t recordTotalSizeBytes) {
-  return ((recordTotalSizeBytes - sizeof(DebugShaderModifierRecordHeader)) /
-          sizeof(uint32_t));
-}
+// Upper bound on the space reserved for a single block of compact steps. Must
+// stay well below DebugBufferDumpingGroundSize so that a block that starts
+// just before the dumping ground cannot run off the end of the UAV.
+constexpr uint32_t CompactTraceMaxBlockSizeInBytes = 1024;
 
 class DxilDebugInstrumentation : public ModulePass {
 
@@ -233,6 +173,18 @@ private:
   uint32_t m_RemainingReservedSpaceInBytes = 0;
   Value *m_CurrentIndex = nullptr;
 
+  // Steps waiting to be written as compact step blocks, in program order.
+  struct PendingStep {
+    Instruction *InsertBefore;
+    DebugShaderModifierRecordType RecordType;
+    std::uint32_t InstNum;
+    Value *V;
+    std::uint32_t ValueOrdinal;
+    Value *ValueOrdinalIndex;
+  };
+  bool m_CompactTrace = false;
+  std::vector<PendingStep> m_PendingSteps;
+
 public:
   static char ID; // Pass identification, replacement for typeid
   explicit DxilDebugInstrumentation() : ModulePass(ID) {}
@@ -261,6 +213,9 @@ private:
   void addStepDebugEntryValue(BuilderContext &BC, std::uint32_t InstNum,
                               Value *V, std::uint32_t ValueOrdinal,
                               Value *ValueOrdinalIndex);
+  void addValueOrdinalEntry(BuilderContext &BC, std::uint32_t ValueOrdinal,
+                            Value *ValueOrdinalIndex);
+  void addCompactStepBlocks(BuilderContext &BC);
   uint32_t UAVDumpingGroundOffset();
   template <typename ReturnType>
   void addStepEntryForType(DebugShaderModifierRecordType RecordType,
@@ -274,6 +229,7 @@ void DxilDebugInstrumentation::applyOptions(PassOptions O) {
   GetPassOptionUnsigned(O, "parameter1", &m_Parameters.Parameters[1], 0);
   GetPassOptionUnsigned(O, "parameter2", &m_Parameters.Parameters[2], 0);
   GetPassOptionUInt64(O, "UAVSize", &m_UAVSize, 1024 * 1024);
+  GetPassOptionBool(O, "compactTrace", &m_CompactTrace, false);
 }
 
 uint32_t DxilDebugInstrumentation::UAVDumpingGroundOffset() {
@@ -776,6 +732,14 @@ void DxilDebugInstrumentation::addStepEntryForType(
     DebugShaderModifierRecordType RecordType, BuilderContext &BC,
     std::uint32_t InstNum, Value *V, std::uint32_t ValueOrdinal,
     Value *ValueOrdinalIndex) {
+  if (m_CompactTrace &&
+      InstNum <= DebugShaderModifierRecordDXILCompactStepMaxOffset) {
+    // Written later, together with the other steps of this block.
+    m_PendingSteps.push_back({&*BC.Builder.GetInsertPoint(), RecordType,
+                              InstNum, V, ValueOrdinal, ValueOrdinalIndex});
+    return;
+  }
+
   DebugShaderModifierRecordDXILStep<ReturnType> step = {};
   reserveDebugEntrySpace(BC, sizeof(step));
 
@@ -788,16 +752,79 @@ void DxilDebugInstrumentation::addStepEntryForType(
 
   if (RecordType != DebugShaderModifierRecordTypeDXILStepVoid) {
     addDebugEntryValue(BC, V);
+    addValueOrdinalEntry(BC, ValueOrdinal, ValueOrdinalIndex);
+  }
+}
 
-    IRBuilder<> &B = BC.Builder;
+void DxilDebugInstrumentation::addValueOrdinalEntry(
+    BuilderContext &BC, std::uint32_t ValueOrdinal, Value *ValueOrdinalIndex) {
+  IRBuilder<> &B = BC.Builder;
+
+  Value *VO = BC.HlslOP->GetU32Const(ValueOrdinal << 16);
+  Value *VOI = B.CreateAnd(ValueOrdinalIndex, BC.HlslOP->GetU32Const(0xFFFF),
+                           "ValueOrdinalIndex");
+  Value *EncodedValueOrdinalAndIndex =
+      BC.Builder.CreateOr(VO, VOI, "ValueOrdinal");
+  addDebugEntryValue(BC, EncodedValueOrdinalAndIndex);
+}
+
+void DxilDebugInstrumentation::addCompactStepBlocks(BuilderContext &BC) {
+  size_t Begin = 0;
+  while (Begin < m_PendingSteps.size()) {
+    // Gather the run of steps from the same basic block that fits in one
+    // reservation.
+    BasicBlock *Block = m_PendingSteps[Begin].InsertBefore->getParent();
+    uint32_t BlockSizeInDwords =
+        sizeof(DebugShaderModifierRecordHeader) / sizeof(uint32_t);
+    size_t End = Begin;
+    while (End < m_PendingSteps.size() &&
+           m_PendingSteps[End].InsertBefore->getParent() == Block) {
+      uint32_t StepSizeInDwords =
+          DebugShaderModifierRecordDXILCompactStepSizeDwords(
+              m_PendingSteps[End].RecordType);
+      if ((BlockSizeInDwords + StepSizeInDwords) * sizeof(uint32_t) >
+          CompactTraceMaxBlockSizeInBytes) {
+        break;
+      }
+      BlockSizeInDwords += StepSizeInDwords;
+      ++End;
+    }
+    assert(End > Begin);
+
+    // Reserve the whole block ahead of its first step. All the other steps
+    // come later in the same basic block, so they can use the reservation.
+    IRBuilder<> Builder(m_PendingSteps[Begin].InsertBefore);
+    BuilderContext BlockBC{BC.M, BC.DM, BC.Ctx, BC.HlslOP, Builder};
+    reserveDebugEntrySpace(BlockBC, BlockSizeInDwords * sizeof(uint32_t));
+
+    DebugShaderModifierRecordHeader header{{{0, 0, 0, 0}}, 0};
+    header.Header.Details.Type = DebugShaderModifierRecordTypeDXILStepBlock;
+    header.Header.Details.HeaderPayload =
+        DebugShaderModifierRecordPayloadSizeDwords(BlockSizeInDwords *
+                                                   sizeof(uint32_t));
+    addDebugEntryValue(BlockBC, BC.HlslOP->GetU32Const(header.Header.u32Header));
+    addDebugEntryValue(BlockBC, m_InvocationId);
+
+    for (size_t i = Begin; i < End; ++i) {
+      const PendingStep &Step = m_PendingSteps[i];
+      IRBuilder<> StepBuilder(Step.InsertBefore);
+      BuilderContext StepBC{BC.M, BC.DM, BC.Ctx, BC.HlslOP, StepBuilder};
+
+      DebugShaderModifierRecordDXILCompactStep step = {};
+      step.Header.Details.InstructionOffset = Step.InstNum;
+      step.Header.Details.Type = static_cast<uint8_t>(Step.RecordType);
+      addDebugEntryValue(StepBC, BC.HlslOP->GetU32Const(step.Header.u32Header));
+
+      if (Step.RecordType != DebugShaderModifierRecordTypeDXILStepVoid) {
+        addDebugEntryValue(StepBC, Step.V);
+        addValueOrdinalEntry(StepBC, Step.ValueOrdinal,
+                             Step.ValueOrdinalIndex);
+      }
+    }
 
-    Value *VO = BC.HlslOP->GetU32Const(ValueOrdinal << 16);
-    Value *VOI = B.CreateAnd(ValueOrdinalIndex, BC.HlslOP->GetU32Const(0xFFFF),
-                             "ValueOrdinalIndex");
-    Value *EncodedValueOrdinalAndIndex =
-        BC.Builder.CreateOr(VO, VOI, "ValueOrdinal");
-    addDebugEntryValue(BC, EncodedValueOrdinalAndIndex);
+    Begin = End;
   }
+  m_PendingSteps.clear();
 }
 
 void DxilDebugInstrumentation::addStoreStepDebugEntry(BuilderContext &BC,
@@ -980,6 +1007,10 @@ bool DxilDebugInstrumentation::runOnModule(Module &M) {
                                           InsertableEdge.first->getParent());
       IRBuilder<> Builder(NewBlock);
 
+      // Add a branch to the new block to point to the current block, and
+      // instrument ahead of it
+      Builder.SetInsertPoint(Builder.CreateBr(&CurrentBlock));
+
       auto *PreviousBlock = InsertableEdge.first;
 
       // Modify all successor operands of the terminator in the previous block
@@ -1014,9 +1045,6 @@ bool DxilDebugInstrumentation::runOnModule(Module &M) {
         addStepDebugEntryValue(BC, InstNum, ValueNPhi.Val, RegNum,
                                BC.Builder.getInt32(0));
       }
-
-      // Add a branch to the new block to point to the current block
-      Builder.CreateBr(&CurrentBlock);
     }
   }
 
@@ -1036,6 +1064,10 @@ bool DxilDebugInstrumentation::runOnModule(Module &M) {
     }
   }
 
+  if (m_CompactTrace) {
+    addCompactStepBlocks(BC);
+  }
+
   DM.ReEmitDxilResources();
 
   return true;
@@ -20,8 +20,10 @@
 
 #include "llvm/IR/PassManager.h"
 #include "llvm/Support/FormattedStream.h"
+#include "llvm/Transforms/Utils/BasicBlockUtils.h"
 #include "llvm/Transforms/Utils/Local.h"
 #include <deque>
+#include <tuple>
 
 #ifdef _WIN32
 #include <winerror.h>
@@ -147,6 +149,12 @@ struct DxilResourceAndClass {
   DXIL::ResourceClass resClass;
 };
 
+struct ResourceAccess {
+  DxilResourceAndClass res;
+  Instruction *instruction;
+  ShaderAccessFlags readWrite;
+};
+
 //---------------------------------------------------------------------------------------------------------------------------------
 
 class DxilShaderAccessTracking : public ModulePass {
@@ -165,12 +173,29 @@ private:
   bool EmitResourceAccess(DxilResourceAndClass &res, Instruction *instruction,
                           OP *HlslOP, LLVMContext &Ctx,
                           ShaderAccessFlags readWrite);
+  void AddResourceAccess(std::vector<ResourceAccess> &accesses,
+                         DxilResourceAndClass &res, Instruction *instruction,
+                         ShaderAccessFlags readWrite);
+  bool IsSampling() const {
+    return m_SamplingRate > 1 || m_WaveLeaderOnly;
+  }
 
 private:
   bool m_CheckForDynamicIndexing = false;
+  // When sampling, only lanes whose wave lane index is a multiple of
+  // m_SamplingRate record their accesses, and if m_WaveLeaderOnly is set,
+  // only the first active lane of each wave does.
+  unsigned m_SamplingRate = 1;
+  bool m_WaveLeaderOnly = false;
+  // Skip accesses to the same slot, with the same access type, as an access
+  // already instrumented in the same basic block.
+  bool m_DedupeAccesses = false;
   std::map<RegisterTypeAndSpace, SlotRange> m_slotAssignments;
   std::map<llvm::Function *, CallInst *> m_FunctionToUAVHandle;
+  std::map<llvm::Function *, Value *> m_FunctionToSampledLane;
   std::set<RSRegisterIdentifier> m_DynamicallyIndexedBindPoints;
+  std::set<std::tuple<BasicBlock *, DxilResourceBase *, Value *, unsigned>>
+      m_InstrumentedAccesses;
 };
 
 static unsigned DeserializeInt(std::deque<char> &q) {
@@ -234,6 +259,10 @@ void DxilShaderAccessTracking::applyOptions(PassOptions O) {
   GetPassOptionInt(O, "checkForDynamicIndexing", &checkForDynamic, 0);
   m_CheckForDynamicIndexing = checkForDynamic != 0;
 
+  GetPassOptionUnsigned(O, "samplingRate", &m_SamplingRate, 1);
+  GetPassOptionBool(O, "waveLeaderOnly", &m_WaveLeaderOnly, false);
+  GetPassOptionBool(O, "dedupeAccesses", &m_DedupeAccesses, false);
+
   StringRef configOption;
   if (GetPassOption(O, "config", &configOption)) {
     std::deque<char> config;
@@ -317,6 +346,29 @@ bool DxilShaderAccessTracking::EmitResourceAccess(DxilResourceAndClass &res,
     IRBuilder<> Builder(instruction);
     Value *slotIndex;
 
+    if (IsSampling()) {
+      // Record the access only from the sampled lanes:
+      Value *IsSampled = nullptr;
+      if (m_SamplingRate > 1) {
+        IsSampled =
+            m_FunctionToSampledLane.at(instruction->getParent()->getParent());
+      }
+      if (m_WaveLeaderOnly) {
+        Function *IsFirstLaneFunc = HlslOP->GetOpFunc(
+            OP::OpCode::WaveIsFirstLane, Type::getVoidTy(Ctx));
+        Constant *IsFirstLaneOpcode =
+            HlslOP->GetU32Const((unsigned)OP::OpCode::WaveIsFirstLane);
+        Value *IsFirstLane = Builder.CreateCall(
+            IsFirstLaneFunc, {IsFirstLaneOpcode}, "IsFirstLane");
+        IsSampled = IsSampled == nullptr
+                        ? IsFirstLane
+                        : Builder.CreateAnd(IsSampled, IsFirstLane, "IsSampled");
+      }
+      TerminatorInst *ThenTerm =
+          SplitBlockAndInsertIfThen(IsSampled, instruction, false);
+      Builder.SetInsertPoint(ThenTerm);
+    }
+
     if (isa<ConstantInt>(res.index)) {
       unsigned index = cast<ConstantInt>(res.index)->getLimitedValue();
       if (index > slot->second.numSlots) {
@@ -364,6 +416,21 @@ bool DxilShaderAccessTracking::EmitResourceAccess(DxilResourceAndClass &res,
   return false; // did not modify
 }
 
+void DxilShaderAccessTracking::AddResourceAccess(
+    std::vector<ResourceAccess> &accesses, DxilResourceAndClass &res,
+    Instruction *instruction, ShaderAccessFlags readWrite) {
+  if (m_DedupeAccesses) {
+    // Tracking only ever writes a 1 to the slot, so once one access to a
+    // given slot executes, the others in the same basic block are redundant.
+    // A constant index, or the same SSA value, yields the same slot.
+    auto key = std::make_tuple(instruction->getParent(), res.resource,
+                               res.index, static_cast<unsigned>(readWrite));
+    if (!m_InstrumentedAccesses.insert(key).second)
+      return;
+  }
+  accesses.push_back({res, instruction, readWrite});
+}
+
 DxilResourceAndClass GetResourceFromHandle(Value *resHandle, DxilModule &DM) {
 
   DxilResourceAndClass ret{nullptr, nullptr, DXIL::ResourceClass::Invalid};
@@ -507,11 +574,33 @@ bool DxilShaderAccessTracking::runOnModule(Module &M) {
               CreateHandleOpFunc,
               {CreateHandleOpcodeArg, UAVArg, MetaDataArg, IndexArg, FalseArg},
               "PIX_CountUAV_Handle");
+
+          if (m_SamplingRate > 1) {
+            // A lane's index in its wave doesn't change, so the lane sampling
+            // test is done once on entry.
+            Function *LaneIndexFunc = HlslOP->GetOpFunc(
+                DXIL::OpCode::WaveGetLaneIndex, Type::getVoidTy(Ctx));
+            Constant *LaneIndexOpcode =
+                HlslOP->GetU32Const((unsigned)DXIL::OpCode::WaveGetLaneIndex);
+            Value *LaneIndex = Builder.CreateCall(
+                LaneIndexFunc, {LaneIndexOpcode}, "LaneIndex");
+            Value *LaneModRate = Builder.CreateURem(
+                LaneIndex, HlslOP->GetU32Const(m_SamplingRate), "LaneModRate");
+            m_FunctionToSampledLane[&F] = Builder.CreateICmpEQ(
+                LaneModRate, HlslOP->GetU32Const(0), "IsSampledLane");
+          }
         }
       }
+      if (IsSampling()) {
+        DM.m_ShaderFlags.SetWaveOps(true);
+      }
       DM.ReEmitDxilResources();
     }
 
+    // Gather all the accesses first: emitting instrumentation may split
+    // basic blocks, which would defeat the per-block deduplication.
+    std::vector<ResourceAccess> accesses;
+
     for (llvm::Function &F : M.functions()) {
       // Only used DXIL intrinsics:
       if (!F.isDeclaration() || F.isIntrinsic() || F.use_empty() ||
@@ -559,15 +648,7 @@ bool DxilShaderAccessTracking::runOnModule(Module &M) {
         case DXIL::OpCode::RayQuery_TraceRayInline: {
           // Read of AccelerationStructure; doesn't match function attribute
           auto res = GetResourceFromHandle(Call->getArgOperand(2), DM);
-          if (EmitResourceAccess(
-            res, 
-            Call, 
-            HlslOP, 
-            Ctx,
-            ShaderAccessFlags::Read)) 
-          {
-            Modified = true;
-          }
+          AddResourceAccess(accesses, res, Call, ShaderAccessFlags::Read);
         }
           continue;
         default:
@@ -581,15 +662,20 @@ bool DxilShaderAccessTracking::runOnModule(Module &M) {
               res.resource->GetSpaceID() == (unsigned)-2) {
             break;
           }
-          if (EmitResourceAccess(res, Call, HlslOP, Ctx, readWrite)) {
-            Modified = true;
-          }
+          AddResourceAccess(accesses, res, Call, readWrite);
           // Remaining resources are DescriptorRead.
           readWrite = ShaderAccessFlags::DescriptorRead;
         }
       }
     }
 
+    for (auto &access : accesses) {
+      if (EmitResourceAccess(access.res, access.instruction, HlslOP, Ctx,
+                             access.readWrite)) {
+        Modified = true;
+      }
+    }
+
     if (OSOverride != nullptr) {
       formatted_raw_ostream FOS(*OSOverride);
       FOS << "DynamicallyIndexedBindPoints=";
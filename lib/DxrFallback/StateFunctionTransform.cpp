@@ -158,6 +158,14 @@ static Value* createCastToInt(Value* val, Instruction* insertBefore)
   if (val->getType() == Type::getInt1Ty(val->getContext()))
     return new ZExtInst(val, i32Ty, addSuffix(val->getName(), ".int"), insertBefore);
 
+  // Widen 16-bit values to a whole int
+  if (val->getType()->getPrimitiveSizeInBits() == 16)
+  {
+    if (!val->getType()->isIntegerTy())
+      val = new BitCastInst(val, Type::getInt16Ty(val->getContext()), addSuffix(val->getName(), ".i16"), insertBefore);
+    return new ZExtInst(val, i32Ty, addSuffix(val->getName(), ".int"), insertBefore);
+  }
+
   Value* intVal = new BitCastInst(val, i32Ty, addSuffix(val->getName(), ".int"), insertBefore);
   return intVal;
 }
@@ -176,10 +184,39 @@ static Value* createCastFromInt(Value* intVal, Type* ty, Instruction* insertBefo
   if (ty == Type::getInt1Ty(intVal->getContext()))
     return new ICmpInst(insertBefore, CmpInst::ICMP_SGT, intVal, makeInt32(0, intVal->getContext()), name);
 
+  // Narrow to 16-bit values from the low half of the int
+  if (ty->getPrimitiveSizeInBits() == 16)
+  {
+    Type* i16Ty = Type::getInt16Ty(intVal->getContext());
+    if (ty == i16Ty)
+      return new TruncInst(intVal, i16Ty, name, insertBefore);
+    Value* i16Val = new TruncInst(intVal, i16Ty, addSuffix(name, ".i16"), insertBefore);
+    return new BitCastInst(i16Val, ty, name, insertBefore);
+  }
+
   return new BitCastInst(intVal, ty, name, insertBefore);
 }
 
 
+// Returns true for scalar values that fit in half of a stack int. Pairs of 
+// these are packed into a single int when saved across a continuation.
+static bool isPackable16BitType(Type* ty)
+{
+  return ty->isHalfTy() || ty->isIntegerTy(16);
+}
+
+
+// Returns the size of the stack space used by a saved value of the given type.
+// Values are stored as a sequence of ints, one per scalar or vector element, 
+// so no padding is needed between saved values.
+static uint64_t getStackSaveSizeInBytes(Type* ty, const DataLayout& DL)
+{
+  if (VectorType* VTy = dyn_cast<VectorType>(ty))
+    return VTy->getVectorNumElements() * sizeof(int);
+  return RoundUpToAlignment(DL.getTypeAllocSize(ty), sizeof(int));
+}
+
+
 // Gives every value in the given function a name. This can aid in debugging.
 static void dbgNameUnnamedVals(Function* func)
 {
@@ -974,6 +1011,8 @@ void StateFunctionTransform::preserveLiveValuesAcrossCallsites(_Out_ unsigned in
     Instruction* saveInsertBefore = m_callSites[i];
     Instruction* restoreInsertBefore = getInstructionAfter(m_callSites[i]);
     Instruction* rematInsertBefore = nullptr; // create only if needed
+    std::vector<Instruction*> savedValues;
+    std::vector<Instruction*> saved16BitValues;
 
     // Rematerialize stack offsets after the continuation before other restores
     for (Instruction* inst : stackOffsets)
@@ -995,17 +1034,10 @@ void StateFunctionTransform::preserveLiveValuesAcrossCallsites(_Out_ unsigned in
       if (!R.canRematerialize(inst))
       {
         assert(!inst->getType()->isPointerTy() && "Can not save pointers");
-
-        offsetInBytes = align(offsetInBytes, inst, DL);
-        AllocaInst* alloca = valToAlloca[inst];
-
-        Value* saveVal = new LoadInst(alloca, addSuffix(inst->getName(), ".save"), saveInsertBefore);
-        createStackStore(saveStackFrameOffset, saveVal, offsetInBytes, saveInsertBefore);
-
-        Value* restoreVal = createStackLoad(restoreStackFrameOffset, inst, offsetInBytes, restoreInsertBefore);
-        new StoreInst(restoreVal, alloca, restoreInsertBefore);
-
-        offsetInBytes += DL.getTypeAllocSize(inst->getType());
+        if (isPackable16BitType(inst->getType()))
+          saved16BitValues.push_back(inst);
+        else
+          savedValues.push_back(inst);
       }
       else if (R.getRematerializedValueFor(inst) == nullptr)
       {
@@ -1022,6 +1054,56 @@ void StateFunctionTransform::preserveLiveValuesAcrossCallsites(_Out_ unsigned in
       }
     }
 
+    // Save values that are not rematerialized. Restores go after the 
+    // rematerialized stack offsets and before any other rematerialization.
+    offsetInBytes = RoundUpToAlignment(offsetInBytes, sizeof(int));
+    for (Instruction* inst : savedValues)
+    {
+      AllocaInst* alloca = valToAlloca[inst];
+
+      Value* saveVal = new LoadInst(alloca, addSuffix(inst->getName(), ".save"), saveInsertBefore);
+      createStackStore(saveStackFrameOffset, saveVal, offsetInBytes, saveInsertBefore);
+
+      Value* restoreVal = createStackLoad(restoreStackFrameOffset, inst, offsetInBytes, restoreInsertBefore);
+      new StoreInst(restoreVal, alloca, restoreInsertBefore);
+
+      offsetInBytes += getStackSaveSizeInBytes(inst->getType(), DL);
+    }
+
+    // Pack pairs of 16-bit values into a single int, low half first.
+    LLVMContext& C = m_function->getContext();
+    for (size_t j = 0; j < saved16BitValues.size(); j += 2)
+    {
+      Instruction* lo = saved16BitValues[j];
+      Instruction* hi = (j + 1 < saved16BitValues.size()) ? saved16BitValues[j + 1] : nullptr;
+
+      Value* loVal = new LoadInst(valToAlloca[lo], addSuffix(lo->getName(), ".save"), saveInsertBefore);
+      Value* packed = createCastToInt(loVal, saveInsertBefore);
+      if (hi)
+      {
+        Value* hiVal = new LoadInst(valToAlloca[hi], addSuffix(hi->getName(), ".save"), saveInsertBefore);
+        Value* hiInt = BinaryOperator::Create(Instruction::Shl, createCastToInt(hiVal, saveInsertBefore), makeInt32(16, C), "", saveInsertBefore);
+        packed = BinaryOperator::Create(Instruction::Or, packed, hiInt, "packed16", saveInsertBefore);
+      }
+      createStackStore(saveStackFrameOffset, packed, offsetInBytes, saveInsertBefore);
+
+      Instruction* restorePacked = createStackLoad(restoreStackFrameOffset, packed, offsetInBytes, restoreInsertBefore);
+      if (hi)
+      {
+        Value* hiInt = BinaryOperator::Create(Instruction::LShr, restorePacked, makeInt32(16, C), addSuffix(hi->getName(), ".restore"), restoreInsertBefore);
+        new StoreInst(createCastFromInt(hiInt, hi->getType(), restoreInsertBefore), valToAlloca[hi], restoreInsertBefore);
+      }
+      new StoreInst(createCastFromInt(restorePacked, lo->getType(), restoreInsertBefore), valToAlloca[lo], restoreInsertBefore);
+
+      offsetInBytes += sizeof(int);
+    }
+
+    if (m_verbose)
+    {
+      DBGS() << stringf("continuation %d: %d saved values, %d bytes\n",
+        (int)i, (int)(savedValues.size() + saved16BitValues.size()), (int)(offsetInBytes - baseOffsetInBytes));
+    }
+
     // Take the max offset over all call sites
     maxOffsetInBytes = std::max(maxOffsetInBytes, offsetInBytes);
   }
@@ -31,6 +31,7 @@
 #include "llvm/Bitcode/ReaderWriter.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/IR/IRPrintingPasses.h"
 #include "llvm/IR/LegacyPassManager.h"
@@ -39,6 +40,7 @@
 #include "llvm/Transforms/IPO/PassManagerBuilder.h"
 
 #include <algorithm>
+#include <chrono>
 #include <list>   // should change this for string_table
 #include <vector>
 
@@ -201,11 +203,11 @@ static ArrayRef<LPCSTR> GetPassArgNames(LPCSTR passName) {
   static const LPCSTR CFGSimplifyPassArgs[] = { "Threshold", "Ftor", "bonus-inst-threshold" };
   static const LPCSTR DxilAddPixelHitInstrumentationArgs[] = { "force-early-z", "add-pixel-cost", "rt-width", "sv-position-index", "num-pixels" };
   static const LPCSTR DxilConditionalMem2RegArgs[] = { "NoOpt" };
-  static const LPCSTR DxilDebugInstrumentationArgs[] = { "UAVSize", "parameter0", "parameter1", "parameter2" };
+  static const LPCSTR DxilDebugInstrumentationArgs[] = { "UAVSize", "parameter0", "parameter1", "parameter2", "compactTrace" };
   static const LPCSTR DxilGenerationPassArgs[] = { "NotOptimized" };
   static const LPCSTR DxilOutputColorBecomesConstantArgs[] = { "mod-mode", "constant-red", "constant-green", "constant-blue", "constant-alpha" };
   static const LPCSTR DxilPIXMeshShaderOutputInstrumentationArgs[] = { "UAVSize" };
-  static const LPCSTR DxilShaderAccessTrackingArgs[] = { "config", "checkForDynamicIndexing" };
+  static const LPCSTR DxilShaderAccessTrackingArgs[] = { "config", "checkForDynamicIndexing", "samplingRate", "waveLeaderOnly", "dedupeAccesses" };
   static const LPCSTR DynamicIndexingVectorToArrayArgs[] = { "ReplaceAllVectors" };
   static const LPCSTR Float2IntArgs[] = { "float2int-max-integer-bw" };
   static const LPCSTR GVNArgs[] = { "noloads", "enable-pre", "enable-load-pre", "max-recurse-depth" };
@@ -278,11 +280,11 @@ static ArrayRef<LPCSTR> GetPassArgDescriptions(LPCSTR passName) {
   static const LPCSTR CFGSimplifyPassArgs[] = { "None", "None", "Control the number of bonus instructions (default = 1)" };
   static const LPCSTR DxilAddPixelHitInstrumentationArgs[] = { "None", "None", "None", "None", "None" };
   static const LPCSTR DxilConditionalMem2RegArgs[] = { "None" };
-  static const LPCSTR DxilDebugInstrumentationArgs[] = { "None", "None", "None", "None" };
+  static const LPCSTR DxilDebugInstrumentationArgs[] = { "None", "None", "None", "None", "None" };
   static const LPCSTR DxilGenerationPassArgs[] = { "None" };
   static const LPCSTR DxilOutputColorBecomesConstantArgs[] = { "None", "None", "None", "None", "None" };
   static const LPCSTR DxilPIXMeshShaderOutputInstrumentationArgs[] = { "None" };
-  static const LPCSTR DxilShaderAccessTrackingArgs[] = { "None", "None" };
+  static const LPCSTR DxilShaderAccessTrackingArgs[] = { "None", "None", "None", "None", "None" };
   static const LPCSTR DynamicIndexingVectorToArrayArgs[] = { "None" };
   static const LPCSTR Float2IntArgs[] = { "Max integer bitwidth to consider in float2int" };
   static const LPCSTR GVNArgs[] = { "None", "None", "None", "Max recurse depth" };
@@ -374,11 +376,13 @@ static bool IsPassOptionName(StringRef S) {
     ||  S.equals("add-pixel-cost")
     ||  S.equals("bonus-inst-threshold")
     ||  S.equals("checkForDynamicIndexing")
+    ||  S.equals("compactTrace")
     ||  S.equals("config")
     ||  S.equals("constant-alpha")
     ||  S.equals("constant-blue")
     ||  S.equals("constant-green")
     ||  S.equals("constant-red")
+    ||  S.equals("dedupeAccesses")
     ||  S.equals("disable-licm-promotion")
     ||  S.equals("enable-load-pre")
     ||  S.equals("enable-pre")
@@ -411,6 +415,7 @@ static bool IsPassOptionName(StringRef S) {
     ||  S.equals("rt-width")
     ||  S.equals("sample-profile-file")
     ||  S.equals("sample-profile-max-propagate-iterations")
+    ||  S.equals("samplingRate")
     ||  S.equals("sroa-random-shuffle-slices")
     ||  S.equals("sroa-strict-inbounds")
     ||  S.equals("sv-position-index")
@@ -423,7 +428,8 @@ static bool IsPassOptionName(StringRef S) {
     ||  S.equals("unroll-runtime")
     ||  S.equals("unroll-threshold")
     ||  S.equals("vector-library")
-    ||  S.equals("verify-debug-info");
+    ||  S.equals("verify-debug-info")
+    ||  S.equals("waveLeaderOnly");
   // ISPASSOPTIONNAME:END
 }
 
@@ -636,6 +642,13 @@ HRESULT STDMETHODCALLTYPE DxcOptimizer::RunOptimizer(
   legacy::PassManager ModulePasses;
   legacy::FunctionPassManager FunctionPasses(M.get());
   legacy::PassManagerBase *pPassManager = &ModulePasses;
+  bool InFunctionPasses = false;
+
+  // With -time-passes, each pass gets a pass manager of its own so that it
+  // can be timed on its own; analyses are then recomputed for every pass.
+  std::vector<std::unique_ptr<legacy::FunctionPassManager>> FunctionStages;
+  std::vector<std::unique_ptr<legacy::PassManager>> ModuleStages;
+  std::vector<std::string> FunctionStageNames, ModuleStageNames;
 
   try {
     CComPtr<AbstractMemoryStream> pOutputStream;
@@ -662,6 +675,7 @@ HRESULT STDMETHODCALLTYPE DxcOptimizer::RunOptimizer(
     //
     bool OutputAssembly = false;
     bool AnalyzeOnly = false;
+    bool TimePasses = false;
 
     // First gather flags, wherever they may be.
     SmallVector<UINT32, 2> handled;
@@ -676,8 +690,28 @@ HRESULT STDMETHODCALLTYPE DxcOptimizer::RunOptimizer(
         handled.push_back(i);
         continue;
       }
+      if (wcseq(L"-time-passes", ppOptions[i])) {
+        TimePasses = true;
+        handled.push_back(i);
+        continue;
+      }
     }
 
+    auto BeginStage = [&](StringRef Name) {
+      if (!TimePasses)
+        return;
+      if (InFunctionPasses) {
+        FunctionStages.emplace_back(
+            llvm::make_unique<legacy::FunctionPassManager>(M.get()));
+        FunctionStageNames.push_back(Name);
+        pPassManager = FunctionStages.back().get();
+      } else {
+        ModuleStages.emplace_back(llvm::make_unique<legacy::PassManager>());
+        ModuleStageNames.push_back(Name);
+        pPassManager = ModuleStages.back().get();
+      }
+    };
+
     // TODO: should really use string_table for this once that's available
     std::list<std::string> optionsAnsi;
     SmallVector<PassOption, 2> options;
@@ -698,18 +732,22 @@ HRESULT STDMETHODCALLTYPE DxcOptimizer::RunOptimizer(
           Banner += name8.m_psz;
           Banner += "\n";
         }
-        if (pPassManager == &ModulePasses)
+        if (!InFunctionPasses) {
+          BeginStage("print-module");
           pPassManager->add(llvm::createPrintModulePass(outStream, Banner));
+        }
         continue;
       }
 
       // Handle special switches to toggle per-function prepasses vs. module passes.
       if (wcseq(ppOptions[i], L"-opt-fn-passes")) {
         pPassManager = &FunctionPasses;
+        InFunctionPasses = true;
         continue;
       }
       if (wcseq(ppOptions[i], L"-opt-mod-passes")) {
         pPassManager = &ModulePasses;
+        InFunctionPasses = false;
         continue;
       }
 
@@ -770,6 +808,7 @@ HRESULT STDMETHODCALLTYPE DxcOptimizer::RunOptimizer(
       pass->setOSOverride(&outStream);
       pass->applyOptions(options);
       options.clear();
+      BeginStage(PassInf->getPassArgument());
       pPassManager->add(pass);
       if (AnalyzeOnly) {
         const bool Quiet = false;
@@ -808,12 +847,44 @@ HRESULT STDMETHODCALLTYPE DxcOptimizer::RunOptimizer(
       raw_ostream *err_ostream = &outStream;
       ScopedFatalErrorHandler errHandler(FatalErrorHandlerStreamWrite, err_ostream);
 
-      FunctionPasses.doInitialization();
-      for (Function &F : *M.get())
-        if (!F.isDeclaration())
-          FunctionPasses.run(F);
-      FunctionPasses.doFinalization();
+      auto RunFunctionPasses = [&](legacy::FunctionPassManager &FPM) {
+        FPM.doInitialization();
+        for (Function &F : *M.get())
+          if (!F.isDeclaration())
+            FPM.run(F);
+        FPM.doFinalization();
+      };
+      typedef std::chrono::steady_clock Clock;
+      std::vector<std::pair<StringRef, double>> StageTimes;
+      auto TimeStage = [&](StringRef Name, Clock::time_point Start) {
+        StageTimes.emplace_back(
+            Name, std::chrono::duration<double, std::milli>(Clock::now() -
+                                                            Start).count());
+      };
+
+      for (unsigned i = 0; i < FunctionStages.size(); ++i) {
+        Clock::time_point Start = Clock::now();
+        RunFunctionPasses(*FunctionStages[i]);
+        TimeStage(FunctionStageNames[i], Start);
+      }
+      RunFunctionPasses(FunctionPasses);
+      for (unsigned i = 0; i < ModuleStages.size(); ++i) {
+        Clock::time_point Start = Clock::now();
+        ModuleStages[i]->run(*M.get());
+        TimeStage(ModuleStageNames[i], Start);
+      }
       ModulePasses.run(*M.get());
+
+      if (TimePasses) {
+        double Total = 0;
+        outStream << "; Pass execution timing (ms):\n";
+        for (auto &Stage : StageTimes) {
+          outStream << ";   " << format("%10.3f", Stage.second) << "  "
+                    << Stage.first << "\n";
+          Total += Stage.second;
+        }
+        outStream << ";   " << format("%10.3f", Total) << "  Total\n";
+      }
     }
 
     outStream.flush();
@@ -29,6 +29,8 @@
 #include "llvm/IR/DebugInfo.h"
 #include "llvm/IR/PassManager.h"
 #include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/Pass.h"
 #include "llvm/Transforms/Utils/Local.h"
 #include "llvm/Analysis/AssumptionCache.h"
@@ -992,6 +994,10 @@ public:
     SmallVector<CallInst *, 16> gradientOps;
     SmallVector<CallInst *, 16> barriers;
     SmallVector<CallInst *, 16> waveOps;
+    // Wave sensitivity only propagates within a function, so only functions
+    // with both wave and gradient ops need to be analyzed.
+    SmallPtrSet<Function *, 4> waveFuncs;
+    DenseMap<Function *, SmallVector<CallInst *, 16>> gradientOpsByFunc;
 
     for (auto &F : M) {
       if (!F.isDeclaration())
@@ -1012,10 +1018,12 @@ public:
 
         if (OP::IsDxilOpWave(dxilOpcode)) {
           waveOps.emplace_back(CI);
+          waveFuncs.insert(CI->getParent()->getParent());
         }
 
         if (OP::IsDxilOpGradient(dxilOpcode)) {
           gradientOps.push_back(CI);
+          gradientOpsByFunc[CI->getParent()->getParent()].emplace_back(CI);
         }
 
         if (dxilOpcode == DXIL::OpCode::Barrier) {
@@ -1033,16 +1041,8 @@ public:
       return false;
 
     for (auto &F : M) {
-      if (F.isDeclaration())
-        continue;
-
-      SmallVector<CallInst *, 16> localGradientOps;
-      for (CallInst *CI : gradientOps) {
-        if (CI->getParent()->getParent() == &F)
-          localGradientOps.emplace_back(CI);
-      }
-
-      if (localGradientOps.empty())
+      auto localGradientOps = gradientOpsByFunc.find(&F);
+      if (localGradientOps == gradientOpsByFunc.end() || !waveFuncs.count(&F))
         continue;
 
       PostDominatorTree PDT;
@@ -1051,7 +1051,7 @@ public:
           WaveSensitivityAnalysis::create(PDT));
 
       WaveVal->Analyze(&F);
-      for (CallInst *op : localGradientOps) {
+      for (CallInst *op : localGradientOps->second) {
         if (WaveVal->IsWaveSensitive(op)) {
           dxilutil::EmitWarningOnInstruction(op,
                                              UniNoWaveSensitiveGradientErrMsg);
@@ -21,6 +21,9 @@
 #include "dxc/DXIL/DxilModule.h"
 #include "dxc/DXIL/DxilUtil.h"
 #include "HLMatrixSubscriptUseReplacer.h"
+#include "llvm/ADT/PostOrderIterator.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/IR/CFG.h"
 
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/Module.h"
@@ -284,10 +287,26 @@ void HLMatrixLowerPass::deleteDeadInsts() {
 
 // Find all instructions consuming or producing matrices,
 // directly or through pointers/arrays.
+// Blocks are visited in reverse post-order, so that matrix values are
+// lowered before their consumers and no mat-to-vec stubs are needed for them.
 void HLMatrixLowerPass::getMatrixAllocasAndOtherInsts(Function &Func,
     std::vector<AllocaInst*> &MatAllocas, std::vector<Instruction*> &MatInsts){
-  for (BasicBlock &BasicBlock : Func) {
-    for (Instruction &Inst : BasicBlock) {
+  std::vector<BasicBlock*> Blocks;
+  Blocks.reserve(Func.size());
+  SmallPtrSet<BasicBlock*, 16> Visited;
+  for (BasicBlock *BB : ReversePostOrderTraversal<Function*>(&Func)) {
+    Blocks.emplace_back(BB);
+    Visited.insert(BB);
+  }
+  // Unreachable blocks still need to be lowered.
+  if (Blocks.size() != Func.size()) {
+    for (BasicBlock &BB : Func)
+      if (!Visited.count(&BB))
+        Blocks.emplace_back(&BB);
+  }
+
+  for (BasicBlock *BasicBlock : Blocks) {
+    for (Instruction &Inst : *BasicBlock) {
       // Don't lower GEPs directly, we'll handle them as we lower the root pointer,
       // typically a global variable or alloca.
       if (isa<GetElementPtrInst>(&Inst)) continue;
@@ -938,6 +957,14 @@ Value *HLMatrixLowerPass::lowerHLMulIntrinsic(Value* Lhs, Value *Rhs,
   Function *MadFunc = GetOrCreateHLFunction(*m_pModule, MadFuncTy, HLOpcodeGroup::HLIntrinsic, (unsigned)MadOpcode);
   Constant *MadOpcodeVal = Builder.getInt32((unsigned)MadOpcode);
 
+  // Extract each operand element once, every one of them is used
+  // by several of the result elements.
+  SmallVector<Value*, 16> LhsElems, RhsElems;
+  for (unsigned ElemIdx = 0; ElemIdx < LhsNumRows * LhsNumCols; ++ElemIdx)
+    LhsElems.emplace_back(Builder.CreateExtractElement(LoweredLhs, static_cast<uint64_t>(ElemIdx)));
+  for (unsigned ElemIdx = 0; ElemIdx < RhsNumRows * RhsNumCols; ++ElemIdx)
+    RhsElems.emplace_back(Builder.CreateExtractElement(LoweredRhs, static_cast<uint64_t>(ElemIdx)));
+
   // Perform the multiplication!
   Value *Result = UndefValue::get(VectorType::get(ElemTy, LhsNumRows * RhsNumCols));
   for (unsigned ResultRowIdx = 0; ResultRowIdx < ResultMatTy.getNumRows(); ++ResultRowIdx) {
@@ -948,8 +975,8 @@ Value *HLMatrixLowerPass::lowerHLMulIntrinsic(Value* Lhs, Value *Rhs,
       for (unsigned AccIdx = 0; AccIdx < AccCount; ++AccIdx) {
         unsigned LhsElemIdx = HLMatrixType::getRowMajorIndex(ResultRowIdx, AccIdx, LhsNumRows, LhsNumCols);
         unsigned RhsElemIdx = HLMatrixType::getRowMajorIndex(AccIdx, ResultColIdx, RhsNumRows, RhsNumCols);
-        Value* LhsElem = Builder.CreateExtractElement(LoweredLhs, static_cast<uint64_t>(LhsElemIdx));
-        Value* RhsElem = Builder.CreateExtractElement(LoweredRhs, static_cast<uint64_t>(RhsElemIdx));
+        Value* LhsElem = LhsElems[LhsElemIdx];
+        Value* RhsElem = RhsElems[RhsElemIdx];
         if (ResultElem == nullptr) {
           ResultElem = ElemTy->isFloatingPointTy()
             ? Builder.CreateFMul(LhsElem, RhsElem)
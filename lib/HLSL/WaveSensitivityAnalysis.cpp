@@ -31,6 +31,7 @@
 #include "llvm/IR/DiagnosticInfo.h"
 #include "llvm/IR/DiagnosticPrinter.h"
 #include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/Analysis/PostDominators.h"
 
 #ifdef _WIN32
@@ -60,8 +61,8 @@ private:
     Unknown
   };
   PostDominatorTree *pPDT;
-  map<Instruction *, WaveSensitivity> InstState;
-  map<BasicBlock *, WaveSensitivity> BBState;
+  DenseMap<Instruction *, WaveSensitivity> InstState;
+  DenseMap<BasicBlock *, WaveSensitivity> BBState;
   std::vector<Instruction *> InstWorkList;
   std::vector<BasicBlock *> BBWorkList;
   bool CheckBBState(BasicBlock *BB, WaveSensitivity WS);
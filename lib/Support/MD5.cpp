@@ -38,6 +38,7 @@
  */
 
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/Support/Endian.h" // HLSL Change
 #include "llvm/Support/Format.h"
 #include "llvm/Support/MD5.h"
 #include "llvm/Support/raw_ostream.h"
@@ -61,11 +62,9 @@
 
 // SET reads 4 input bytes in little-endian byte order and stores them
 // in a properly aligned word in host byte order.
+// HLSL Change - read whole words instead of assembling them byte by byte.
 #define SET(n)                                                                 \
-  (block[(n)] =                                                                \
-       (MD5_u32plus) ptr[(n) * 4] | ((MD5_u32plus) ptr[(n) * 4 + 1] << 8) |    \
-       ((MD5_u32plus) ptr[(n) * 4 + 2] << 16) |                                \
-       ((MD5_u32plus) ptr[(n) * 4 + 3] << 24))
+  (block[(n)] = support::endian::read32le(ptr + (n) * 4))
 #define GET(n) (block[(n)])
 
 namespace llvm {
@@ -235,6 +235,13 @@ bool CanConvert(
   bool explicitConversion,
   _Inout_opt_ clang::StandardConversionSequence* standard);
 
+// Builds the process-wide indexes over the built-in intrinsic tables. Call
+// once when the library loads, with the default allocator in place, and pair
+// with CleanupIntrinsicTables on unload. Until then, lookups scan the tables.
+// Returns false if out of memory.
+bool InitializeIntrinsicTables();
+void CleanupIntrinsicTables();
+
 // This function takes the external sema source rather than the sema object itself
 // because the wire-up doesn't happen until parsing is initialized and we want
 // to set this up earlier. If the HLSL constructs in the external sema move to
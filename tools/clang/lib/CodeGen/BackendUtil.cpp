@@ -43,6 +43,7 @@
 #include <memory>
 #include "dxc/HLSL/DxilGenerationPass.h" // HLSL Change
 #include "dxc/HLSL/HLMatrixLowerPass.h"  // HLSL Change
+#include "dxc/Support/DxcTrace.h"       // HLSL Change
 
 using namespace clang;
 using namespace llvm;
@@ -710,6 +711,7 @@ void EmitAssemblyHelper::EmitAssembly(BackendAction Action,
 
   if (PerFunctionPasses) {
     PrettyStackTraceString CrashInfo("Per-function optimization");
+    hlsl::trace::ScopedEvent TracePasses("PerFunctionPasses"); // HLSL Change
 
     PerFunctionPasses->doInitialization();
     for (Function &F : *TheModule)
@@ -720,11 +722,13 @@ void EmitAssemblyHelper::EmitAssembly(BackendAction Action,
 
   if (PerModulePasses) {
     PrettyStackTraceString CrashInfo("Per-module optimization passes");
+    hlsl::trace::ScopedEvent TracePasses("PerModulePasses"); // HLSL Change
     PerModulePasses->run(*TheModule);
   }
 
   if (CodeGenPasses) {
     PrettyStackTraceString CrashInfo("Code generation");
+    hlsl::trace::ScopedEvent TracePasses("CodeGenPasses"); // HLSL Change
     CodeGenPasses->run(*TheModule);
   }
 }
@@ -34,6 +34,7 @@
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/Timer.h"
+#include "dxc/Support/DxcTrace.h" // HLSL Change
 #include <memory>
 using namespace clang;
 using namespace llvm;
@@ -140,6 +141,7 @@ namespace clang {
     void HandleTranslationUnit(ASTContext &C) override {
       {
         PrettyStackTraceString CrashInfo("Per-file LLVM IR generation");
+        hlsl::trace::ScopedEvent TraceIRGen("IRGeneration"); // HLSL Change
         if (llvm::TimePassesIsEnabled)
           LLVMIRGeneration.startTimer();
 
@@ -23,6 +23,7 @@
 #include "clang/Sema/Sema.h"
 #include "clang/Sema/SemaConsumer.h"
 #include "clang/Sema/SemaHLSL.h" // HLSL Change
+#include "dxc/Support/DxcTrace.h" // HLSL Change
 #include "llvm/Support/CrashRecoveryContext.h"
 #include <cstdio>
 #include <memory>
@@ -132,24 +133,27 @@ void clang::ParseAST(Sema &S, bool PrintStats, bool SkipFunctionBodies) {
   if (External)
     External->StartTranslationUnit(Consumer);
 
-  if (!S.getDiagnostics().hasUnrecoverableErrorOccurred()) {  // HLSL Change: Skip if fatal error already occurred
-    if (P.ParseTopLevelDecl(ADecl)) {
-      if (!External && !S.getLangOpts().CPlusPlus)
-        P.Diag(diag::ext_empty_translation_unit);
-    } else {
-      do {
-        // If we got a null return and something *was* parsed, ignore it.  This
-        // is due to a top-level semicolon, an action override, or a parse error
-        // skipping something.
-        if (ADecl && !Consumer->HandleTopLevelDecl(ADecl.get()))
-          return;
-      } while (!P.ParseTopLevelDecl(ADecl));
-    }
-  } // HLSL Change: Skip if fatal error already occurred
-
-  // Process any TopLevelDecls generated by #pragma weak.
-  for (Decl *D : S.WeakTopLevelDecls())
-    Consumer->HandleTopLevelDecl(DeclGroupRef(D));
+  { // HLSL Change: Trace parsing separately from the consumer.
+    hlsl::trace::ScopedEvent TraceParse("Parse"); // HLSL Change
+    if (!S.getDiagnostics().hasUnrecoverableErrorOccurred()) {  // HLSL Change: Skip if fatal error already occurred
+      if (P.ParseTopLevelDecl(ADecl)) {
+        if (!External && !S.getLangOpts().CPlusPlus)
+          P.Diag(diag::ext_empty_translation_unit);
+      } else {
+        do {
+          // If we got a null return and something *was* parsed, ignore it.
+          // This is due to a top-level semicolon, an action override, or a
+          // parse error skipping something.
+          if (ADecl && !Consumer->HandleTopLevelDecl(ADecl.get()))
+            return;
+        } while (!P.ParseTopLevelDecl(ADecl));
+      }
+    } // HLSL Change: Skip if fatal error already occurred
+
+    // Process any TopLevelDecls generated by #pragma weak.
+    for (Decl *D : S.WeakTopLevelDecls())
+      Consumer->HandleTopLevelDecl(DeclGroupRef(D));
+  } // HLSL Change
   
   // HLSL Change Starts
   // Provide the opportunity to generate translation-unit level validation
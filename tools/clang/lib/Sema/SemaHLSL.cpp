@@ -12,6 +12,7 @@
 
 #include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringMap.h"
 #include "clang/AST/ASTContext.h"
 #include "clang/AST/Attr.h"
 #include "clang/AST/DeclCXX.h"
@@ -1514,6 +1515,23 @@ const SubscriptOperatorRecord g_ArBasicKindsSubscripts[] =
 
 C_ASSERT(_countof(g_ArBasicKindsAsTypes) == _countof(g_ArBasicKindsSubscripts));
 
+// Returns the index of the specified kind in g_ArBasicKindsAsTypes, or -1 if
+// the kind isn't represented as a type. The index is built once per process.
+static
+int GetBasicKindTypeIndex(ArBasicKind kind)
+{
+  struct KindTypeIndex {
+    int Index[AR_BASIC_MAXIMUM_COUNT];
+    KindTypeIndex() {
+      std::fill(std::begin(Index), std::end(Index), -1);
+      for (unsigned i = 0; i < _countof(g_ArBasicKindsAsTypes); i++)
+        Index[g_ArBasicKindsAsTypes[i]] = i;
+    }
+  };
+  static const KindTypeIndex index;
+  return (unsigned)kind < AR_BASIC_MAXIMUM_COUNT ? index.Index[kind] : -1;
+}
+
 // Type names for ArBasicKind values.
 static
 const char* g_ArBasicTypeNames[] =
@@ -2079,6 +2097,85 @@ class UsedIntrinsicStore : public std::set<UsedIntrinsic>
 {
 };
 
+/// <summary>
+/// Index from intrinsic name to the first entry in g_Intrinsics with that name
+/// for each argument count. Built by hlsl::InitializeIntrinsicTables when the
+/// library loads, so it is allocated with the default allocator rather than
+/// the allocator of whichever compilation first needs it.
+/// </summary>
+class IntrinsicNameIndex
+{
+  typedef llvm::SmallVector<const HLSL_INTRINSIC*, 2> EntryList;
+  llvm::StringMap<EntryList> m_entries;
+
+public:
+  IntrinsicNameIndex(_In_count_(tableSize) const HLSL_INTRINSIC* table, size_t tableSize)
+  {
+    for (size_t i = 0; i < tableSize; i++) {
+      const HLSL_INTRINSIC* pIntrinsic = &table[i];
+      EntryList& entries = m_entries[pIntrinsic->pArgs[0].pName];
+      bool found = false;
+      for (const HLSL_INTRINSIC* pEntry : entries) {
+        if (pEntry->uNumArgs == pIntrinsic->uNumArgs) {
+          found = true;
+          break;
+        }
+      }
+      if (!found)
+        entries.push_back(pIntrinsic);
+    }
+  }
+
+  /// <summary>Returns the first entry with the given name and number of arguments (including return), or nullptr.</summary>
+  const HLSL_INTRINSIC* Find(StringRef name, unsigned numArgs) const
+  {
+    auto it = m_entries.find(name);
+    if (it == m_entries.end())
+      return nullptr;
+    for (const HLSL_INTRINSIC* pEntry : it->second) {
+      if (pEntry->uNumArgs == numArgs)
+        return pEntry;
+    }
+    return nullptr;
+  }
+};
+
+// Index over g_Intrinsics, or nullptr if hlsl::InitializeIntrinsicTables has
+// not been called, in which case lookups scan the table.
+static IntrinsicNameIndex* g_pIntrinsicNameIndex;
+
+/// <summary>
+/// Caches the overload chosen for a call to a global intrinsic by the
+/// canonical types of its arguments, so repeated calls skip argument matching.
+/// </summary>
+class IntrinsicCallCache
+{
+public:
+  typedef llvm::SmallVector<QualType, 4> ArgTypeList;
+
+private:
+  typedef std::pair<ArgTypeList, FunctionDecl*> Entry;
+  llvm::DenseMap<const IdentifierInfo*, llvm::SmallVector<Entry, 2>> m_entries;
+
+public:
+  FunctionDecl* Find(const IdentifierInfo* name, const ArgTypeList& argTypes) const
+  {
+    auto it = m_entries.find(name);
+    if (it == m_entries.end())
+      return nullptr;
+    for (const Entry& entry : it->second) {
+      if (entry.first == argTypes)
+        return entry.second;
+    }
+    return nullptr;
+  }
+
+  void Insert(const IdentifierInfo* name, const ArgTypeList& argTypes, FunctionDecl* decl)
+  {
+    m_entries[name].push_back(std::make_pair(argTypes, decl));
+  }
+};
+
 static
 void GetIntrinsicMethods(ArBasicKind kind, _Outptr_result_buffer_(*intrinsicCount) const HLSL_INTRINSIC** intrinsics, _Out_ size_t* intrinsicCount)
 {
@@ -2220,6 +2317,74 @@ void GetIntrinsicMethods(ArBasicKind kind, _Outptr_result_buffer_(*intrinsicCoun
   }
 }
 
+// Checks whether the two specified intrinsics generate equivalent templates.
+// For example: foo (any_int) and foo (any_float) are only unambiguous in the context
+// of HLSL intrinsic rules, and their difference can't be expressed with C++ templates.
+static
+bool AreIntrinsicTemplatesEquivalent(const HLSL_INTRINSIC* left, const HLSL_INTRINSIC* right)
+{
+  if (left == right)
+  {
+    return true;
+  }
+  if (left == nullptr || right == nullptr)
+  {
+    return false;
+  }
+
+  return (left->uNumArgs == right->uNumArgs &&
+    0 == strcmp(left->pArgs[0].pName, right->pArgs[0].pName));
+}
+
+// Appends the methods of the specified object kind that each generate a
+// distinct template, in table order.
+static
+void CollectIntrinsicMethodTemplates(ArBasicKind kind, SmallVectorImpl<const HLSL_INTRINSIC*>& templates)
+{
+  const HLSL_INTRINSIC* intrinsics;
+  const HLSL_INTRINSIC* prior = nullptr;
+  size_t intrinsicCount;
+
+  GetIntrinsicMethods(kind, &intrinsics, &intrinsicCount);
+  DXASSERT(
+    (intrinsics == nullptr) == (intrinsicCount == 0),
+    "intrinsic table pointer must match count (null for zero, something valid otherwise");
+
+  for (size_t i = 0; i < intrinsicCount; i++) {
+    if (!AreIntrinsicTemplatesEquivalent(&intrinsics[i], prior)) {
+      templates.push_back(&intrinsics[i]);
+      prior = &intrinsics[i];
+    }
+  }
+}
+
+// Method templates for every object kind. Built by
+// hlsl::InitializeIntrinsicTables when the library loads, so the lists are
+// allocated with the default allocator rather than a compilation's.
+struct IntrinsicMethodTemplates {
+  SmallVector<const HLSL_INTRINSIC*, 8> Templates[AR_BASIC_MAXIMUM_COUNT];
+  IntrinsicMethodTemplates() {
+    for (unsigned k = 0; k < AR_BASIC_MAXIMUM_COUNT; k++)
+      CollectIntrinsicMethodTemplates((ArBasicKind)k, Templates[k]);
+  }
+};
+
+// Method templates, or nullptr if hlsl::InitializeIntrinsicTables has not been
+// called, in which case they are collected for each object type declared.
+static IntrinsicMethodTemplates* g_pIntrinsicMethodTemplates;
+
+// Returns the methods of the specified object kind that each generate a
+// distinct template. Uses storage when the templates haven't been built.
+static
+ArrayRef<const HLSL_INTRINSIC*> GetIntrinsicMethodTemplates(ArBasicKind kind, SmallVectorImpl<const HLSL_INTRINSIC*>& storage)
+{
+  DXASSERT_NOMSG((unsigned)kind < AR_BASIC_MAXIMUM_COUNT);
+  if (g_pIntrinsicMethodTemplates != nullptr)
+    return g_pIntrinsicMethodTemplates->Templates[kind];
+  CollectIntrinsicMethodTemplates(kind, storage);
+  return storage;
+}
+
 static
 bool IsRowOrColumnVariable(size_t value)
 {
@@ -2888,6 +3053,9 @@ private:
 
   UsedIntrinsicStore m_usedIntrinsics;
 
+  // Overloads chosen for calls to global intrinsics.
+  IntrinsicCallCache m_intrinsicCallCache;
+
   /// <summary>Add all base QualTypes for each hlsl scalar types.</summary>
   void AddBaseTypes();
 
@@ -3051,48 +3219,16 @@ private:
     }
   }
 
-  // Checks whether the two specified intrinsics generate equivalent templates.
-  // For example: foo (any_int) and foo (any_float) are only unambiguous in the context
-  // of HLSL intrinsic rules, and their difference can't be expressed with C++ templates.
-  bool AreIntrinsicTemplatesEquivalent(const HLSL_INTRINSIC* left, const HLSL_INTRINSIC* right)
-  {
-    if (left == right)
-    {
-      return true;
-    }
-    if (left == nullptr || right == nullptr)
-    {
-      return false;
-    }
-
-    return (left->uNumArgs == right->uNumArgs &&
-      0 == strcmp(left->pArgs[0].pName, right->pArgs[0].pName));
-  }
-
   // Adds all the intrinsic methods that correspond to the specified type.
   void AddObjectMethods(ArBasicKind kind, _In_ CXXRecordDecl* recordDecl, int templateDepth)
   {
     DXASSERT_NOMSG(recordDecl != nullptr);
     DXASSERT_NOMSG(templateDepth >= 0);
 
-    const HLSL_INTRINSIC* intrinsics;
-    const HLSL_INTRINSIC* prior = nullptr;
-    size_t intrinsicCount;
-
-    GetIntrinsicMethods(kind, &intrinsics, &intrinsicCount);
-    DXASSERT(
-      (intrinsics == nullptr) == (intrinsicCount == 0),
-      "intrinsic table pointer must match count (null for zero, something valid otherwise");
-
-    while (intrinsicCount--)
+    SmallVector<const HLSL_INTRINSIC*, 32> templates;
+    for (const HLSL_INTRINSIC* intrinsic : GetIntrinsicMethodTemplates(kind, templates))
     {
-      if (!AreIntrinsicTemplatesEquivalent(intrinsics, prior))
-      {
-        AddObjectIntrinsicTemplate(recordDecl, templateDepth, intrinsics);
-        prior = intrinsics;
-      }
-
-      intrinsics++;
+      AddObjectIntrinsicTemplate(recordDecl, templateDepth, intrinsic);
     }
   }
 
@@ -4028,9 +4164,8 @@ public:
     case AR_OBJECT_RAY_DESC:
     case AR_OBJECT_TRIANGLE_INTERSECTION_ATTRIBUTES:
     {
-        const ArBasicKind* match = std::find(g_ArBasicKindsAsTypes, &g_ArBasicKindsAsTypes[_countof(g_ArBasicKindsAsTypes)], kind);
-        DXASSERT(match != &g_ArBasicKindsAsTypes[_countof(g_ArBasicKindsAsTypes)], "otherwise can't find constant in basic kinds");
-        size_t index = match - g_ArBasicKindsAsTypes;
+        int index = GetBasicKindTypeIndex(kind);
+        DXASSERT(index != -1, "otherwise can't find constant in basic kinds");
         return m_context->getTagDeclType(this->m_objectTypeDecls[index]);
     }
 
@@ -4156,14 +4291,18 @@ public:
     StringRef nameIdentifier,
     size_t argumentCount)
   {
-    // This is implemented by a linear scan for now.
-    // We tested binary search on tables, and there was no performance gain on
-    // samples probably for the following reasons.
-    // 1. The tables are not big enough to make noticable difference
-    // 2. The user of this function assumes that it returns the first entry in
-    // the table that matches name and argument count. So even in the binary
-    // search, we have to scan backwards until the entry does not match the name
-    // or arg count. For linear search this is not a problem
+    // The global intrinsic table is large and searched on every call, so it
+    // is looked up in a name index that holds the first matching entry.
+    if (table == g_Intrinsics && g_pIntrinsicNameIndex != nullptr) {
+      const HLSL_INTRINSIC* pIntrinsic = g_pIntrinsicNameIndex->Find(nameIdentifier, 1 + argumentCount);
+      return IntrinsicDefIter::CreateStart(table, tableSize, pIntrinsic ? pIntrinsic : table + tableSize,
+        IntrinsicTableDefIter::CreateStart(m_intrinsicTables, typeName, nameIdentifier, argumentCount));
+    }
+
+    // Object method tables are small and are searched with a linear scan, as
+    // is the global table when the index hasn't been built.
+    // The user of this function assumes that it returns the first entry in
+    // the table that matches name and argument count.
     for (unsigned int i = 0; i < tableSize; i++) {
       const HLSL_INTRINSIC* pIntrinsic = &table[i];
 
@@ -4183,6 +4322,20 @@ public:
       IntrinsicTableDefIter::CreateStart(m_intrinsicTables, typeName, nameIdentifier, argumentCount));
   }
 
+  /// <summary>Gets the canonical argument types that identify an intrinsic call in the call cache.</summary>
+  /// <remarks>Returns false if the call can't be cached, because matching depends on more than the argument types.</remarks>
+  bool GetIntrinsicCallCacheKey(ArrayRef<Expr *> Args, IntrinsicCallCache::ArgTypeList& argTypes)
+  {
+    for (Expr* pArg : Args) {
+      // Literal arguments are given a concrete type based on their value.
+      ArBasicKind kind = GetTypeElementKind(pArg->getType());
+      if (kind == AR_BASIC_LITERAL_INT || kind == AR_BASIC_LITERAL_FLOAT)
+        return false;
+      argTypes.push_back(pArg->getType().getCanonicalType());
+    }
+    return true;
+  }
+
   bool AddOverloadedCallCandidates(
     UnresolvedLookupExpr *ULE,
     ArrayRef<Expr *> Args,
@@ -4206,6 +4359,20 @@ public:
 
     StringRef nameIdentifier = idInfo->getName();
 
+    // Reuse the overload chosen by an earlier call with the same argument types.
+    IntrinsicCallCache::ArgTypeList cacheArgTypes;
+    bool cacheable = GetIntrinsicCallCacheKey(Args, cacheArgTypes);
+    if (cacheable) {
+      if (FunctionDecl* cachedDecl = m_intrinsicCallCache.Find(idInfo, cacheArgTypes)) {
+        OverloadCandidate& candidate = CandidateSet.addCandidate();
+        candidate.Function = cachedDecl;
+        candidate.FoundDecl.setDecl(cachedDecl);
+        candidate.Viable = true;
+        return true;
+      }
+    }
+    DiagnosticErrorTrap errorTrap(m_sema->getDiagnostics());
+
     IntrinsicDefIter cursor = FindIntrinsicByNameAndArgCount(
       g_Intrinsics, _countof(g_Intrinsics), StringRef(), nameIdentifier, Args.size());
     IntrinsicDefIter end = IntrinsicDefIter::CreateEnd(
@@ -4244,6 +4411,12 @@ public:
         intrinsicFuncDecl = (*insertResult.first).getFunctionDecl();
       }
 
+      // Matching may diagnose arguments of rejected candidates; only cache
+      // clean resolutions so those diagnostics are reported on every call.
+      if (cacheable && !errorTrap.hasErrorOccurred()) {
+        m_intrinsicCallCache.Insert(idInfo, cacheArgTypes, intrinsicFuncDecl);
+      }
+
       OverloadCandidate& candidate = CandidateSet.addCandidate();
       candidate.Function = intrinsicFuncDecl;
       candidate.FoundDecl.setDecl(intrinsicFuncDecl);
@@ -12714,6 +12887,28 @@ void hlsl::Indent(unsigned int Indentation, llvm::raw_ostream &Out)
     Out << "  ";
 }
 
+bool hlsl::InitializeIntrinsicTables()
+{
+  DXASSERT(g_pIntrinsicNameIndex == nullptr && g_pIntrinsicMethodTemplates == nullptr, "else double-init");
+  try {
+    g_pIntrinsicNameIndex = new IntrinsicNameIndex(g_Intrinsics, _countof(g_Intrinsics));
+    g_pIntrinsicMethodTemplates = new IntrinsicMethodTemplates();
+  }
+  catch (std::bad_alloc&) {
+    CleanupIntrinsicTables();
+    return false;
+  }
+  return true;
+}
+
+void hlsl::CleanupIntrinsicTables()
+{
+  delete g_pIntrinsicNameIndex;
+  g_pIntrinsicNameIndex = nullptr;
+  delete g_pIntrinsicMethodTemplates;
+  g_pIntrinsicMethodTemplates = nullptr;
+}
+
 void hlsl::RegisterIntrinsicTable(_In_ clang::ExternalSemaSource* self, _In_ IDxcIntrinsicTable* table)
 {
   DXASSERT_NOMSG(self != nullptr);
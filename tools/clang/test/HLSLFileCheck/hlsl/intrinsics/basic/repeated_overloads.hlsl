@@ -0,0 +1,16 @@
+// RUN: %dxc -T ps_6_0 -E main %s | %FileCheck %s
+
+// Repeated calls with the same argument types reuse the chosen overload,
+// while calls with other or literal argument types resolve on their own.
+// repeated_overloads_ast.hlsl checks which declarations the calls resolve to.
+
+// CHECK-DAG: call float @dx.op.unary.f32(i32 6, float %{{.*}})
+// CHECK-DAG: call float @dx.op.unary.f32(i32 6, float %{{.*}})
+// CHECK-DAG: call i32 @dx.op.binary.i32(i32 37, i32 %{{.*}}, i32 %{{.*}})
+// CHECK-DAG: call float @dx.op.binary.f32(i32 35, float %{{.*}}, float 1.000000e+00)
+
+float main(float a : A, float c : C, int b : B) : SV_Target {
+  float x = abs(a) + abs(c);
+  int y = abs(b);
+  return x + y + max(a, 1);
+}
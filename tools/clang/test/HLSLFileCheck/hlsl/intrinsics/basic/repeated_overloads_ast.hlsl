@@ -0,0 +1,17 @@
+// RUN: %dxc -T ps_6_0 -E main -ast-dump %s | %FileCheck %s
+
+// A repeated call with the same argument types reuses the declaration chosen
+// for the first call. Calls with literal arguments are not cached, and resolve
+// the literal from the other arguments on every call.
+
+// CHECK: DeclRefExpr {{.*}} Function [[ABSF:0x[0-9a-f]+]] 'abs' 'float (float)'
+// CHECK: DeclRefExpr {{.*}} Function [[ABSF]] 'abs' 'float (float)'
+// CHECK: DeclRefExpr {{.*}} Function {{0x[0-9a-f]+}} 'abs' 'int (int)'
+// CHECK: DeclRefExpr {{.*}} Function {{0x[0-9a-f]+}} 'max' 'float (float, float)'
+// CHECK: DeclRefExpr {{.*}} Function {{0x[0-9a-f]+}} 'max' 'int (int, int)'
+
+float main(float a : A, float c : C, int b : B) : SV_Target {
+  float x = abs(a) + abs(c);
+  int y = abs(b);
+  return x + y + max(a, 1) + max(b, 1);
+}
@@ -0,0 +1,21 @@
+// RUN: %dxc -ECSMain -Tcs_6_0 %s | %opt -S -hlsl-dxil-pix-shader-access-instrumentation,config=S0:0:1i0;..,dedupeAccesses=1 | %FileCheck %s
+
+// Check that repeated reads of the same buffer in one basic block are only
+// recorded once:
+
+// CHECK: %PIX_CountUAV_Handle = call %dx.types.Handle @dx.op.createHandle(i32 57, i8 1, i32 1, i32 0, i1 false)
+// CHECK: call void @dx.op.bufferStore.i32(i32 69, %dx.types.Handle %PIX_CountUAV_Handle
+// CHECK-NOT: call void @dx.op.bufferStore.i32(i32 69, %dx.types.Handle %PIX_CountUAV_Handle
+// CHECK: ret void
+
+ByteAddressBuffer inBuffer : register(t0);
+RWByteAddressBuffer outBuffer : register(u0);
+
+[numthreads(1, 1, 1)]
+void CSMain(uint3 tid : SV_DispatchThreadID)
+{
+  uint a = inBuffer.Load(tid.x * 4);
+  uint b = inBuffer.Load(tid.y * 4);
+  uint c = inBuffer.Load(tid.z * 4);
+  outBuffer.Store(0, a + b + c);
+}
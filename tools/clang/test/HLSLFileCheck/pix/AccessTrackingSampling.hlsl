@@ -0,0 +1,22 @@
+// RUN: %dxc -ECSMain -Tcs_6_0 %s | %opt -S -hlsl-dxil-pix-shader-access-instrumentation,config=S0:0:1i0;..,samplingRate=4,waveLeaderOnly=1 | %FileCheck %s
+
+// Check that the lane sampling test is done once on entry:
+// CHECK: %PIX_CountUAV_Handle = call %dx.types.Handle @dx.op.createHandle(i32 57, i8 1, i32 1, i32 0, i1 false)
+// CHECK: %LaneIndex = call i32 @dx.op.waveGetLaneIndex(i32 111)
+// CHECK: %LaneModRate = urem i32 %LaneIndex, 4
+// CHECK: %IsSampledLane = icmp eq i32 %LaneModRate, 0
+
+// Check that the access is only recorded by the sampled wave leader:
+// CHECK: %IsFirstLane = call i1 @dx.op.waveIsFirstLane(i32 110)
+// CHECK: %IsSampled = and i1 %IsSampledLane, %IsFirstLane
+// CHECK: br i1 %IsSampled
+// CHECK: call void @dx.op.bufferStore.i32(i32 69, %dx.types.Handle %PIX_CountUAV_Handle
+
+ByteAddressBuffer inBuffer : register(t0);
+RWByteAddressBuffer outBuffer : register(u0);
+
+[numthreads(1, 1, 1)]
+void CSMain(uint3 tid : SV_DispatchThreadID)
+{
+  outBuffer.Store(0, inBuffer.Load(tid.x * 4));
+}
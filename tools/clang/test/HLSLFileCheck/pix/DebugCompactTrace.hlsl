@@ -0,0 +1,25 @@
+// RUN: %dxc -Emain -Tps_6_0 %s | %opt -S -dxil-annotate-with-virtual-regs -hlsl-dxil-debug-instrumentation,compactTrace=1 | %FileCheck %s
+
+// Check that with compactTrace the steps of a basic block share a single
+// reservation in the UAV, rather than one atomic increment per step.
+
+// The invocation start marker is unchanged:
+// CHECK: %IncrementForThisInvocation = mul i32 8, %OffsetMultiplicand
+
+// Eight float steps of three dwords each, plus the two-dword block header:
+// CHECK: %IncrementForThisInvocation1 = mul i32 104, %OffsetMultiplicand
+// CHECK: %UAVIncResult2 = call i32 @dx.op.atomicBinOp.i32(i32 78, %dx.types.Handle %PIX_DebugUAV_Handle, i32 0, i32 0, i32 undef, i32 undef, i32 %IncrementForThisInvocation1)
+
+// Block header: type DXILStepBlock (250), 24 payload dwords:
+// CHECK: call void @dx.op.bufferStore.i32(i32 69, %dx.types.Handle %PIX_DebugUAV_Handle, i32 %AddedForInterest{{[0-9]+}}, i32 undef, i32 1636864,
+
+// First compact step: type DXILStepFloat (252) in the top byte:
+// CHECK: call void @dx.op.bufferStore.i32(i32 69, %dx.types.Handle %PIX_DebugUAV_Handle, i32 {{%[0-9]+}}, i32 undef, i32 -671088{{[0-9]+}},
+
+// CHECK-NOT: call i32 @dx.op.atomicBinOp.i32
+// CHECK: ret void
+
+[RootSignature("")]
+float4 main(float4 pos : SV_Position) : SV_Target {
+    return pos * 2;
+}
@@ -11,6 +11,26 @@
 
 #include "dxclib/dxc.h"
 
+#ifndef _WIN32
+#include "dxc/dxcapi.h"
+
+// dxc does not link dxcompiler on Unix, so that dxc --connect starts without
+// loading it; dxcompiler is loaded on demand, and the interface IDs that dxc
+// uses are defined here.
+DEFINE_CROSS_PLATFORM_UUIDOF(IDxcBlob)
+DEFINE_CROSS_PLATFORM_UUIDOF(IDxcBlobEncoding)
+DEFINE_CROSS_PLATFORM_UUIDOF(IDxcBlobUtf16)
+DEFINE_CROSS_PLATFORM_UUIDOF(IDxcBlobUtf8)
+DEFINE_CROSS_PLATFORM_UUIDOF(IDxcCompiler)
+DEFINE_CROSS_PLATFORM_UUIDOF(IDxcCompiler2)
+DEFINE_CROSS_PLATFORM_UUIDOF(IDxcContainerBuilder)
+DEFINE_CROSS_PLATFORM_UUIDOF(IDxcIncludeHandler)
+DEFINE_CROSS_PLATFORM_UUIDOF(IDxcLibrary)
+DEFINE_CROSS_PLATFORM_UUIDOF(IDxcResult)
+DEFINE_CROSS_PLATFORM_UUIDOF(IDxcVersionInfo)
+DEFINE_CROSS_PLATFORM_UUIDOF(IDxcVersionInfo2)
+#endif // _WIN32
+
 #ifdef _WIN32
 int __cdecl wmain(int argc, const wchar_t **argv_) 
 {
@@ -59,12 +59,26 @@
 #include "llvm/Option/ArgList.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/xxhash.h"
 #ifdef _WIN32
 #include <dia2.h>
 #include <comdef.h>
 #endif
 #include <algorithm>
 #include <unordered_map>
+#ifndef _WIN32
+#include <climits>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <set>
+#include <thread>
+#endif
 
 #pragma comment(lib, "version.lib")
 
@@ -120,6 +134,7 @@ class DxcContext {
 private:
   DxcOpts &m_Opts;
   DxcDllSupport &m_dxcSupport;
+  IDxcIncludeHandler *m_pIncludeHandler;
 
   int ActOnBlob(IDxcBlob *pBlob);
   int ActOnBlob(IDxcBlob *pBlob, IDxcBlob *pDebugBlob, LPCWSTR pDebugBlobName);
@@ -145,8 +160,12 @@ private:
   }
 
 public:
-  DxcContext(DxcOpts &Opts, DxcDllSupport &dxcSupport)
-      : m_Opts(Opts), m_dxcSupport(dxcSupport) {
+  // pIncludeHandler, when given, loads included files in place of the
+  // library's file system include handler.
+  DxcContext(DxcOpts &Opts, DxcDllSupport &dxcSupport,
+             IDxcIncludeHandler *pIncludeHandler = nullptr)
+      : m_Opts(Opts), m_dxcSupport(dxcSupport),
+        m_pIncludeHandler(pIncludeHandler) {
   }
 
   int  Compile();
@@ -191,6 +210,20 @@ static void WritePartToFile(IDxcBlob *pBlob, hlsl::DxilFourCC CC,
   }
 }
 
+// Writes the 64-bit xxHash of the blob, little-endian, for -Fch.
+static void WriteContentHashToFile(IDxcBlob *pBlob, llvm::StringRef FName,
+                                   UINT32 textCodePage) {
+  uint8_t ContentHash[sizeof(uint64_t)];
+  llvm::support::endian::write64le(
+      ContentHash, llvm::xxHash64(llvm::StringRef(
+                       (const char *)pBlob->GetBufferPointer(),
+                       pBlob->GetBufferSize())));
+  CComPtr<IDxcBlob> pHashBlob;
+  IFT(hlsl::DxcCreateBlobOnHeapCopy(ContentHash, (UINT32)sizeof(ContentHash),
+                                    &pHashBlob));
+  WriteBlobToFile(pHashBlob, FName, textCodePage);
+}
+
 static void WriteDxcOutputToFile(DXC_OUT_KIND kind, IDxcResult *pResult, UINT32 textCodePage) {
   if (pResult->HasOutput(kind)) {
     CComPtr<IDxcBlob> pData;
@@ -216,15 +249,24 @@ int DxcContext::ActOnBlob(IDxcBlob *pBlob, IDxcBlob *pDebugBlob, LPCWSTR pDebugB
   }
 
   // Write the output blob.
+  CComPtr<IDxcBlob> pUpdatedBlob;
   if (!m_Opts.OutputObject.empty()) {
     // For backward compatability: fxc requires /Fo for /extractrootsignature
     if (!m_Opts.ExtractRootSignature) {
-      CComPtr<IDxcBlob> pResult;
-      UpdatePart(pBlob, &pResult);
-      WriteBlobToFile(pResult, m_Opts.OutputObject, m_Opts.DefaultTextCodePage);
+      UpdatePart(pBlob, &pUpdatedBlob);
+      WriteBlobToFile(pUpdatedBlob, m_Opts.OutputObject, m_Opts.DefaultTextCodePage);
     }
   }
 
+  // Hash the container after the container options have been applied, so
+  // that the hash matches the bytes written with /Fo.
+  if (!m_Opts.OutputContentHashFile.empty()) {
+    if (!pUpdatedBlob)
+      UpdatePart(pBlob, &pUpdatedBlob);
+    WriteContentHashToFile(pUpdatedBlob, m_Opts.OutputContentHashFile,
+                           m_Opts.DefaultTextCodePage);
+  }
+
   // Verify Root Signature
   if (!m_Opts.VerifyRootSignatureSource.empty()) {
     return VerifyRootSignature();
@@ -770,8 +812,9 @@ int DxcContext::Compile() {
       Recompile(pSource, pLibrary, pCompiler, args, outputPDBPath, pDebugBlob,
                 &pCompileResult);
     } else {
-      CComPtr<IDxcIncludeHandler> pIncludeHandler;
-      IFT(pLibrary->CreateIncludeHandler(&pIncludeHandler));
+      CComPtr<IDxcIncludeHandler> pIncludeHandler = m_pIncludeHandler;
+      if (!pIncludeHandler)
+        IFT(pLibrary->CreateIncludeHandler(&pIncludeHandler));
 
       // Upgrade profile to 6.0 version from minimum recognized shader model
       llvm::StringRef TargetProfile = m_Opts.TargetProfile;
@@ -858,9 +901,10 @@ void DxcContext::Preprocess() {
   std::vector<LPCWSTR> args;
 
   CComPtr<IDxcLibrary> pLibrary;
-  CComPtr<IDxcIncludeHandler> pIncludeHandler;
+  CComPtr<IDxcIncludeHandler> pIncludeHandler = m_pIncludeHandler;
   IFT(CreateInstance(CLSID_DxcLibrary, &pLibrary));
-  IFT(pLibrary->CreateIncludeHandler(&pIncludeHandler));
+  if (!pIncludeHandler)
+    IFT(pLibrary->CreateIncludeHandler(&pIncludeHandler));
 
   // Carry forward the options that control preprocessor
   if (m_Opts.LegacyMacroExpansion)
@@ -1179,18 +1223,21 @@ void DxcContext::GetCompilerVersionInfo(llvm::raw_string_ostream &OS) {
 #define VERSION_STRING_SUFFIX ""
 #endif
 
+// Runs one dxc command line. pIncludeHandler, when given, loads included
+// files in place of the file system.
 #ifdef _WIN32
-int dxc::main(int argc, const wchar_t **argv_) {
+static int RunDxc(int argc, const wchar_t **argv_,
+                  IDxcIncludeHandler *pIncludeHandler) {
 #else
-int dxc::main(int argc, const char **argv_) {
+static int RunDxc(int argc, const char **argv_,
+                  IDxcIncludeHandler *pIncludeHandler) {
 #endif // _WIN32
   const char *pStage = "Operation";
   int retVal = 0;
-  if (FAILED(DxcInitThreadMalloc())) return 1;
-  DxcSetThreadMallocToDefault();
   try {
     pStage = "Argument processing";
-    if (initHlslOptTable()) throw std::bad_alloc();
+    // A compile server builds the table before it starts its workers.
+    if (!getHlslOptTable() && initHlslOptTable()) throw std::bad_alloc();
 
     // Parse command line options.
     const OptTable *optionTable = getHlslOptTable();
@@ -1232,7 +1279,7 @@ int dxc::main(int argc, const char **argv_) {
     }
 
     EnsureEnabled(dxcSupport);
-    DxcContext context(dxcOpts, dxcSupport);
+    DxcContext context(dxcOpts, dxcSupport, pIncludeHandler);
     // Handle help request, which overrides any other processing.
     if (dxcOpts.ShowHelp) {
       std::string helpString;
@@ -1314,3 +1361,484 @@ int dxc::main(int argc, const char **argv_) {
 
   return retVal;
 }
+
+#ifndef _WIN32
+///////////////////////////////////////////////////////////////////////////////
+// Compile server.
+//
+// dxc --server SOCKET [-j N] keeps N worker processes, one per core by
+// default, waiting on the Unix domain socket SOCKET. They are forked from a
+// process that has loaded dxcompiler, built the option table and compiled a
+// shader, so they start warm. Each worker accepts connections one at a time
+// and runs their command lines as dxc would; after a fixed number of commands
+// it exits and the server forks a replacement, so that memory a command leaks
+// or fragments does not build up. Stopping the server ends its workers, busy
+// or not.
+//
+// dxc --connect SOCKET ARGS... is the client. It sends ARGS, its working
+// directory and its standard handles to a worker, reads the files the worker
+// includes, and exits with the command's exit code. The worker reads the main
+// input and writes outputs itself, relative to the client's directory, so the
+// server must run as the same user on the same file system. If no server is
+// listening, the client runs the command in its own process.
+
+// Messages are a DxcServerMessageHeader followed by Size bytes.
+enum class DxcServerMessage : uint32_t {
+  Command,       // Client: the working directory, then the arguments, each
+                 // null-terminated. Carries stdin, stdout and stderr.
+  LoadSource,    // Worker: the UTF-8 name of a file to include.
+  Source,        // Client: the contents of that file.
+  SourceMissing, // Client: the file could not be read.
+  Exit,          // Worker: the int32_t exit code of the command.
+};
+
+struct DxcServerMessageHeader {
+  DxcServerMessage Kind;
+  uint32_t Size;
+};
+
+static bool SendAll(int fd, const void *pData, size_t size) {
+  const char *p = (const char *)pData;
+  while (size > 0) {
+    ssize_t n = send(fd, p, size, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return false;
+    p += n;
+    size -= n;
+  }
+  return true;
+}
+
+static bool RecvAll(int fd, void *pData, size_t size) {
+  char *p = (char *)pData;
+  while (size > 0) {
+    ssize_t n = recv(fd, p, size, 0);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return false;
+    p += n;
+    size -= n;
+  }
+  return true;
+}
+
+static bool SendServerMessage(int fd, DxcServerMessage kind,
+                              const void *pData, uint32_t size) {
+  DxcServerMessageHeader header = {kind, size};
+  return SendAll(fd, &header, sizeof(header)) && SendAll(fd, pData, size);
+}
+
+static bool RecvServerMessage(int fd, DxcServerMessage &kind,
+                              std::string &data) {
+  DxcServerMessageHeader header;
+  if (!RecvAll(fd, &header, sizeof(header)))
+    return false;
+  kind = header.Kind;
+  data.resize(header.Size);
+  return RecvAll(fd, &data[0], header.Size);
+}
+
+// Sends the command message, with the given handles attached.
+static bool SendCommand(int fd, const std::string &payload,
+                        const int (&handles)[3]) {
+  DxcServerMessageHeader header = {DxcServerMessage::Command,
+                                   (uint32_t)payload.size()};
+  iovec iov = {&header, sizeof(header)};
+  union {
+    char buf[CMSG_SPACE(sizeof(handles))];
+    cmsghdr align;
+  } control;
+  memset(&control, 0, sizeof(control));
+  msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control.buf;
+  msg.msg_controllen = sizeof(control.buf);
+  cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(handles));
+  memcpy(CMSG_DATA(cmsg), handles, sizeof(handles));
+  ssize_t n;
+  do {
+    n = sendmsg(fd, &msg, MSG_NOSIGNAL);
+  } while (n < 0 && errno == EINTR);
+  if (n < 0)
+    return false;
+  return SendAll(fd, (const char *)&header + n, sizeof(header) - n) &&
+         SendAll(fd, payload.data(), payload.size());
+}
+
+static bool RecvCommand(int fd, std::string &payload, int (&handles)[3]) {
+  DxcServerMessageHeader header;
+  iovec iov = {&header, sizeof(header)};
+  union {
+    char buf[CMSG_SPACE(sizeof(handles))];
+    cmsghdr align;
+  } control;
+  msghdr msg = {};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control.buf;
+  msg.msg_controllen = sizeof(control.buf);
+  ssize_t n;
+  do {
+    n = recvmsg(fd, &msg, 0);
+  } while (n < 0 && errno == EINTR);
+  if (n <= 0)
+    return false;
+  cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+  if (!cmsg || cmsg->cmsg_level != SOL_SOCKET ||
+      cmsg->cmsg_type != SCM_RIGHTS ||
+      cmsg->cmsg_len != CMSG_LEN(sizeof(handles)))
+    return false;
+  memcpy(handles, CMSG_DATA(cmsg), sizeof(handles));
+  if (RecvAll(fd, (char *)&header + n, sizeof(header) - n) &&
+      header.Kind == DxcServerMessage::Command) {
+    payload.resize(header.Size);
+    if (RecvAll(fd, &payload[0], header.Size))
+      return true;
+  }
+  for (int handle : handles)
+    close(handle);
+  return false;
+}
+
+// Loads included files by asking the client for them.
+class DxcIncludeHandlerForServer : public IDxcIncludeHandler {
+private:
+  DXC_MICROCOM_REF_FIELD(m_dwRef)
+  int m_Connection;
+
+public:
+  DXC_MICROCOM_ADDREF_RELEASE_IMPL(m_dwRef)
+  DxcIncludeHandlerForServer(int connection)
+      : m_dwRef(0), m_Connection(connection) {}
+
+  HRESULT STDMETHODCALLTYPE QueryInterface(REFIID iid, void **ppvObject) override {
+    return DoBasicQueryInterface<IDxcIncludeHandler>(this, iid, ppvObject);
+  }
+
+  HRESULT STDMETHODCALLTYPE LoadSource(
+    _In_ LPCWSTR pFilename,
+    _COM_Outptr_result_maybenull_ IDxcBlob **ppIncludeSource
+  ) override {
+    try {
+      *ppIncludeSource = nullptr;
+      std::string name = Unicode::UTF16ToUTF8StringOrThrow(pFilename);
+      DxcServerMessage kind;
+      std::string contents;
+      if (!SendServerMessage(m_Connection, DxcServerMessage::LoadSource,
+                             name.data(), (uint32_t)name.size()) ||
+          !RecvServerMessage(m_Connection, kind, contents))
+        return E_FAIL;
+      if (kind != DxcServerMessage::Source)
+        return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+      IFT(hlsl::DxcCreateBlobOnHeapCopy(contents.data(),
+                                        (UINT32)contents.size(),
+                                        ppIncludeSource));
+    }
+    CATCH_CPP_RETURN_HRESULT()
+    return S_OK;
+  }
+};
+
+// Runs the command received on conn with the client's handles and directory.
+static void ServeCommand(int conn) {
+  std::string payload;
+  int handles[3];
+  if (!RecvCommand(conn, payload, handles))
+    return;
+  for (int i = 0; i < 3; ++i) {
+    if (handles[i] != i) {
+      dup2(handles[i], i);
+      close(handles[i]);
+    }
+  }
+  std::vector<const char *> args;
+  if (!payload.empty() && payload.back() == '\0') {
+    for (size_t i = 0; i < payload.size(); i += strlen(&payload[i]) + 1)
+      args.push_back(&payload[i]);
+  }
+
+  int32_t exitCode = 1;
+  if (args.size() < 2) {
+    fprintf(stderr, "dxc failed : no command line received.\n");
+  } else if (chdir(args[0]) != 0) {
+    fprintf(stderr, "dxc failed : cannot change to directory %s: %s\n",
+            args[0], strerror(errno));
+  } else {
+    CComPtr<DxcIncludeHandlerForServer> pIncludeHandler =
+        new DxcIncludeHandlerForServer(conn);
+    exitCode = RunDxc((int)args.size() - 1, args.data() + 1, pIncludeHandler);
+  }
+  // Output must reach the client's handles before it sees the exit code.
+  fflush(nullptr);
+  SendServerMessage(conn, DxcServerMessage::Exit, &exitCode, sizeof(exitCode));
+}
+
+// Serves connections in a worker process until it has run
+// kServerCommandsPerWorker commands, then exits so the server forks a fresh
+// replacement.
+static const unsigned kServerCommandsPerWorker = 1000;
+
+static void ServeConnections(int listenFd) {
+  int nullFd = open("/dev/null", O_RDWR | O_CLOEXEC);
+  if (nullFd < 0)
+    _exit(2);
+  for (unsigned i = 0; i < kServerCommandsPerWorker; ++i) {
+    int conn;
+    do {
+      conn = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+    } while (conn < 0 && errno == EINTR);
+    if (conn < 0)
+      _exit(2); // Tells the server that the socket no longer works.
+    ServeCommand(conn);
+    close(conn);
+    // Drop the client's handles, so that it sees its pipes close.
+    for (int fd = 0; fd < 3; ++fd)
+      dup2(nullFd, fd);
+  }
+  _exit(0);
+}
+
+// Loads dxcompiler and compiles a small shader, so that workers forked
+// afterwards find the library and the state it builds on first use in memory.
+static HRESULT WarmUpCompiler(DxcDllSupport &dxcSupport) {
+  static const char source[] = "float4 main() : SV_Target { return 1; }";
+  CComPtr<IDxcLibrary> pLibrary;
+  CComPtr<IDxcCompiler> pCompiler;
+  CComPtr<IDxcBlobEncoding> pSource;
+  CComPtr<IDxcOperationResult> pResult;
+  HRESULT status;
+  IFR(dxcSupport.Initialize());
+  IFR(dxcSupport.CreateInstance(CLSID_DxcLibrary, &pLibrary));
+  IFR(dxcSupport.CreateInstance(CLSID_DxcCompiler, &pCompiler));
+  IFR(pLibrary->CreateBlobWithEncodingFromPinned(source, sizeof(source) - 1,
+                                                 CP_UTF8, &pSource));
+  IFR(pCompiler->Compile(pSource, L"warmup.hlsl", L"main", L"ps_6_0", nullptr,
+                         0, nullptr, 0, nullptr, &pResult));
+  IFR(pResult->GetStatus(&status));
+  return status;
+}
+
+static volatile sig_atomic_t g_ServerStopRequested = 0;
+
+static void OnServerStop(int) { g_ServerStopRequested = 1; }
+
+static bool GetSocketAddress(const char *pPath, sockaddr_un &addr) {
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (strlen(pPath) >= sizeof(addr.sun_path))
+    return false;
+  strcpy(addr.sun_path, pPath);
+  return true;
+}
+
+static int RunServer(int argc, const char **argv_) {
+  const char *pSocketPath = nullptr;
+  unsigned workerCount = 0;
+  bool validArgs = true;
+  for (int i = 2; i < argc; ++i) {
+    if (strcmp(argv_[i], "-j") == 0 && i + 1 < argc)
+      workerCount = strtoul(argv_[++i], nullptr, 10);
+    else if (!pSocketPath)
+      pSocketPath = argv_[i];
+    else
+      validArgs = false;
+  }
+  sockaddr_un addr;
+  if (!validArgs || !pSocketPath || !GetSocketAddress(pSocketPath, addr)) {
+    fprintf(stderr, "usage: dxc --server SOCKET [-j N]\n");
+    return 1;
+  }
+  if (workerCount == 0)
+    workerCount = std::max(1u, std::thread::hardware_concurrency());
+
+  if (initHlslOptTable()) {
+    fprintf(stderr, "dxc failed : out of memory.\n");
+    return 1;
+  }
+  DxcDllSupport dxcSupport;
+  HRESULT hr = WarmUpCompiler(dxcSupport);
+  if (FAILED(hr)) {
+    fprintf(stderr, "dxc failed : cannot run the compiler, error code 0x%08x.\n",
+            (unsigned)hr);
+    return 1;
+  }
+
+  // Leave a socket that another server is listening on alone.
+  int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listenFd >= 0 &&
+      connect(listenFd, (const sockaddr *)&addr, sizeof(addr)) == 0) {
+    fprintf(stderr, "dxc failed : a server is already listening on %s.\n",
+            pSocketPath);
+    close(listenFd);
+    return 1;
+  }
+  if (listenFd >= 0)
+    close(listenFd);
+  unlink(pSocketPath);
+  listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+  mode_t oldMask = umask(077); // Only this user may connect.
+  bool listening = listenFd >= 0 &&
+                   bind(listenFd, (const sockaddr *)&addr, sizeof(addr)) == 0 &&
+                   listen(listenFd, SOMAXCONN) == 0;
+  umask(oldMask);
+  if (!listening) {
+    fprintf(stderr, "dxc failed : cannot listen on %s: %s\n", pSocketPath,
+            strerror(errno));
+    if (listenFd >= 0)
+      close(listenFd);
+    return 1;
+  }
+
+  // No SA_RESTART, so that waitpid returns when the server is stopped.
+  struct sigaction stopAction;
+  memset(&stopAction, 0, sizeof(stopAction));
+  stopAction.sa_handler = OnServerStop;
+  sigaction(SIGINT, &stopAction, nullptr);
+  sigaction(SIGTERM, &stopAction, nullptr);
+
+  std::set<pid_t> workers;
+  while (listening && !g_ServerStopRequested) {
+    while (workers.size() < workerCount) {
+      fflush(nullptr);
+      pid_t pid = fork();
+      if (pid == 0) {
+        signal(SIGINT, SIG_DFL);
+        signal(SIGTERM, SIG_DFL);
+        ServeConnections(listenFd);
+      }
+      if (pid < 0) {
+        fprintf(stderr, "dxc failed : cannot start a worker: %s\n",
+                strerror(errno));
+        listening = false;
+        break;
+      }
+      workers.insert(pid);
+    }
+    int status;
+    pid_t pid = waitpid(-1, &status, 0);
+    if (pid < 0) {
+      if (errno == EINTR)
+        continue;
+      break;
+    }
+    workers.erase(pid);
+    if (WIFEXITED(status) && WEXITSTATUS(status) == 2)
+      listening = false;
+  }
+
+  for (pid_t pid : workers)
+    kill(pid, SIGTERM);
+  for (pid_t pid : workers)
+    waitpid(pid, nullptr, 0);
+  close(listenFd);
+  unlink(pSocketPath);
+  return g_ServerStopRequested ? 0 : 1;
+}
+
+static bool ReadFileForServer(const char *pName, std::string &contents) {
+  int fd = open(pName, O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return false;
+  struct stat st;
+  bool ok = fstat(fd, &st) == 0 && S_ISREG(st.st_mode) &&
+            (uint64_t)st.st_size <= UINT32_MAX;
+  if (ok) {
+    contents.resize(st.st_size);
+    size_t offset = 0;
+    while (ok && offset < contents.size()) {
+      ssize_t n = read(fd, &contents[offset], contents.size() - offset);
+      if (n < 0 && errno == EINTR)
+        continue;
+      ok = n > 0;
+      if (ok)
+        offset += n;
+    }
+  }
+  close(fd);
+  return ok;
+}
+
+static int RunClient(int argc, const char **argv_) {
+  if (argc < 3) {
+    fprintf(stderr, "usage: dxc --connect SOCKET ARGUMENTS...\n");
+    return 1;
+  }
+  std::vector<const char *> args;
+  args.push_back(argv_[0]);
+  args.insert(args.end(), argv_ + 3, argv_ + argc);
+
+  sockaddr_un addr;
+  int fd = GetSocketAddress(argv_[2], addr) ? socket(AF_UNIX, SOCK_STREAM, 0)
+                                            : -1;
+  if (fd < 0 || connect(fd, (const sockaddr *)&addr, sizeof(addr)) != 0) {
+    if (fd >= 0)
+      close(fd);
+    return RunDxc((int)args.size(), args.data(), nullptr);
+  }
+
+  std::string payload;
+  std::vector<char> cwd(PATH_MAX);
+  if (!getcwd(cwd.data(), cwd.size())) {
+    fprintf(stderr, "dxc failed : cannot get the working directory: %s\n",
+            strerror(errno));
+    close(fd);
+    return 1;
+  }
+  payload.append(cwd.data()).push_back('\0');
+  for (const char *arg : args)
+    payload.append(arg).push_back('\0');
+
+  // The worker writes to the same handles.
+  fflush(nullptr);
+  const int handles[3] = {STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO};
+  if (SendCommand(fd, payload, handles)) {
+    DxcServerMessage kind;
+    std::string data;
+    while (RecvServerMessage(fd, kind, data)) {
+      if (kind == DxcServerMessage::Exit && data.size() == sizeof(int32_t)) {
+        int32_t exitCode;
+        memcpy(&exitCode, data.data(), sizeof(exitCode));
+        close(fd);
+        return exitCode;
+      }
+      if (kind != DxcServerMessage::LoadSource)
+        break;
+      std::string contents;
+      bool sent = ReadFileForServer(data.c_str(), contents)
+                      ? SendServerMessage(fd, DxcServerMessage::Source,
+                                          contents.data(),
+                                          (uint32_t)contents.size())
+                      : SendServerMessage(fd, DxcServerMessage::SourceMissing,
+                                          nullptr, 0);
+      if (!sent)
+        break;
+    }
+  }
+  close(fd);
+  fprintf(stderr, "dxc failed : lost the connection to the compile server.\n");
+  return 1;
+}
+#endif // _WIN32
+
+#ifdef _WIN32
+int dxc::main(int argc, const wchar_t **argv_) {
+#else
+int dxc::main(int argc, const char **argv_) {
+#endif // _WIN32
+  if (FAILED(DxcInitThreadMalloc())) return 1;
+  DxcSetThreadMallocToDefault();
+#ifndef _WIN32
+  if (argc >= 2 && strcmp(argv_[1], "--server") == 0)
+    return RunServer(argc, argv_);
+  if (argc >= 2 && strcmp(argv_[1], "--connect") == 0)
+    return RunClient(argc, argv_);
+#endif // _WIN32
+  return RunDxc(argc, argv_, nullptr);
+}
@@ -22,6 +22,8 @@
 namespace hlsl {
 HRESULT SetupRegistryPassForHLSL();
 HRESULT SetupRegistryPassForPIX();
+bool InitializeIntrinsicTables();
+void CleanupIntrinsicTables();
 } // namespace hlsl
 
 // C++ exception specification ignored except to indicate a function is not __declspec(nothrow)
@@ -65,6 +67,10 @@ static HRESULT InitMaybeFail() throw() {
     hr = E_FAIL;
     goto Cleanup;
   }
+  if (!hlsl::InitializeIntrinsicTables()) {
+    hr = E_OUTOFMEMORY;
+    goto Cleanup;
+  }
 Cleanup:
   if (FAILED(hr)) {
     if (fsSetup) {
@@ -82,12 +88,16 @@ Cleanup:
 }
 #if defined(LLVM_ON_UNIX)
 HRESULT __attribute__ ((constructor)) DllMain() {
-  return InitMaybeFail();
+  DxcEtw_DXCompilerInitialization_Start();
+  HRESULT hr = InitMaybeFail();
+  DxcEtw_DXCompilerInitialization_Stop(hr);
+  return hr;
 }
 
 void __attribute__ ((destructor)) DllShutdown() {
   DxcSetThreadMallocToDefault();
   ::hlsl::options::cleanupHlslOptTable();
+  ::hlsl::CleanupIntrinsicTables();
   ::llvm::sys::fs::CleanupPerThreadFileSystem();
   ::llvm::llvm_shutdown();
   DxcClearThreadMalloc();
@@ -107,6 +117,7 @@ BOOL WINAPI DllMain(HINSTANCE hinstDLL, DWORD Reason, LPVOID reserved) {
     DxcEtw_DXCompilerShutdown_Start();
     DxcSetThreadMallocToDefault();
     ::hlsl::options::cleanupHlslOptTable();
+    ::hlsl::CleanupIntrinsicTables();
     ::llvm::sys::fs::CleanupPerThreadFileSystem();
     ::llvm::llvm_shutdown();
     if (reserved == NULL) { // FreeLibrary has been called or the DLL load failed
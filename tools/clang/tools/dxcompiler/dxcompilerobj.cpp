@@ -24,6 +24,8 @@
 #include "clang/Frontend/FrontendActions.h"
 #include "clang/CodeGen/CodeGenAction.h"
 #include "llvm/IR/LLVMContext.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/xxhash.h"
 #include "dxc/Support/WinIncludes.h"
 #include "dxc/HLSL/HLSLExtensionsCodegenHelper.h"
 #include "dxc/DxilRootSignature/DxilRootSignature.h"
@@ -391,6 +393,10 @@ static void CreateDefineStrings(
   }
 }
 
+// Compile and Disassemble keep all per-call state on the stack of the call,
+// and the file system is installed for the calling thread only. The language
+// extensions and container events handler are configuration, only read by
+// calls, and must not be changed while calls are in flight.
 class DxcCompiler : public IDxcCompiler3,
                     public IDxcLangExtensions,
                     public IDxcContainerEvent,
@@ -574,6 +580,7 @@ public:
       IFT(pResult->SetOutputName(DXC_OUT_SHADER_HASH, opts.OutputShaderHashFile));
       IFT(pResult->SetOutputName(DXC_OUT_ERRORS, opts.OutputWarningsFile));
       IFT(pResult->SetOutputName(DXC_OUT_ROOT_SIGNATURE, opts.OutputRootSigFile));
+      IFT(pResult->SetOutputName(DXC_OUT_CONTENT_HASH, opts.OutputContentHashFile));
 
       if (opts.DisplayIncludeProcess)
         msfPtr->EnableDisplayIncludeProcess();
@@ -858,6 +865,21 @@ public:
             CComPtr<IDxcBlob> pHashBlob;
             IFT(hlsl::DxcCreateBlobOnHeapCopy(&ShaderHashContent, (UINT32)sizeof(ShaderHashContent), &pHashBlob));
             IFT(pResult->SetOutputObject(DXC_OUT_SHADER_HASH, pHashBlob));
+
+            // Content hash is opt-in (-Fch): a fast non-cryptographic hash of
+            // the final container, for build systems that only need to detect
+            // changed output. It does not replace the DxilShaderHash.
+            if (!opts.OutputContentHashFile.empty() && pOutputBlob) {
+              uint8_t ContentHash[sizeof(uint64_t)];
+              llvm::support::endian::write64le(
+                  ContentHash,
+                  llvm::xxHash64(llvm::StringRef(
+                      (const char *)pOutputBlob->GetBufferPointer(),
+                      pOutputBlob->GetBufferSize())));
+              CComPtr<IDxcBlob> pContentHashBlob;
+              IFT(hlsl::DxcCreateBlobOnHeapCopy(ContentHash, (UINT32)sizeof(ContentHash), &pContentHashBlob));
+              IFT(pResult->SetOutputObject(DXC_OUT_CONTENT_HASH, pContentHashBlob));
+            }
           } // SUCCEEDED(valHR)
         } // compileOK && !opts.CodeGenHighLevel
       }
@@ -953,16 +975,31 @@ public:
       ::llvm::sys::fs::AutoPerThreadSystem pts(msf.get());
       IFTLLVM(pts.error_code());
 
-      std::string StreamStr;
-      raw_string_ostream Stream(StreamStr);
+      // Print straight into the memory that backs the result blob, rather
+      // than into a string that would then be copied into a blob.
+      CComPtr<AbstractMemoryStream> pDisassemblyStream;
+      IFT(CreateMemoryStream(m_pMalloc, &pDisassemblyStream));
+      CComPtr<IDxcBlobUtf8> pDisassembly;
+      {
+        raw_stream_ostream Stream(pDisassemblyStream);
 
-      CComPtr<IDxcBlobEncoding> pProgram;
-      IFT(hlsl::DxcCreateBlob(pObject->Ptr, pObject->Size, true, false, false, 0, nullptr, &pProgram))
-      IFC(dxcutil::Disassemble(pProgram, Stream));
+        CComPtr<IDxcBlobEncoding> pProgram;
+        IFT(hlsl::DxcCreateBlob(pObject->Ptr, pObject->Size, true, false, false, 0, nullptr, &pProgram))
+        IFC(dxcutil::Disassemble(pProgram, Stream));
+        Stream << '\0';
+      }
+      // Tag the stream as UTF-8 so the null-terminated text is wrapped in
+      // place, rather than detected as ACP and converted.
+      CComPtr<IDxcBlob> pDisassemblyBlob;
+      CComPtr<IDxcBlobEncoding> pDisassemblyText;
+      IFT(pDisassemblyStream.QueryInterface(&pDisassemblyBlob));
+      IFT(hlsl::DxcCreateBlobWithEncodingSet(m_pMalloc, pDisassemblyBlob,
+                                             CP_UTF8, &pDisassemblyText));
+      IFT(hlsl::DxcGetBlobAsUtf8(pDisassemblyText, m_pMalloc, &pDisassembly));
 
       IFT(DxcResult::Create(S_OK, DXC_OUT_DISASSEMBLY, {
-          DxcOutputObject::StringOutput(DXC_OUT_DISASSEMBLY,
-            CP_UTF8, StreamStr.c_str(), StreamStr.size(), DxcOutNoName)
+          DxcOutputObject::DataOutput(DXC_OUT_DISASSEMBLY,
+            CP_UTF8, pDisassembly, DxcOutNoName)
         }, &pResult));
       IFT(pResult->QueryInterface(riid, ppResult));
 
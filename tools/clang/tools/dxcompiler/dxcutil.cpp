@@ -12,6 +12,7 @@
 #include "dxc/Support/WinIncludes.h"
 #include "dxc/DxilContainer/DxilContainerAssembler.h"
 #include "dxc/Support/Global.h"
+#include "dxc/Support/DxcTrace.h"
 #include "dxc/Support/FileIOHelper.h"
 #include "dxc/dxcapi.h"
 #include "dxcutil.h"
@@ -24,7 +25,6 @@
 #include "llvm/IR/Module.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/raw_ostream.h"
-#include "llvm/Transforms/Utils/Cloning.h"
 #include "dxc/Support/dxcapi.impl.h"
 #include "dxc/Support/HLSLOptions.h"
 #include "dxc/DXIL/DxilModule.h"
@@ -107,6 +107,7 @@ void GetValidatorVersion(unsigned *pMajor, unsigned *pMinor) {
 }
 
 void AssembleToContainer(AssembleInputs &inputs) {
+  hlsl::trace::ScopedEvent TraceAssemble("DxilContainerAssembly");
   CComPtr<AbstractMemoryStream> pContainerStream;
   IFT(CreateMemoryStream(inputs.pMalloc, &pContainerStream));
   SerializeDxilContainerForModule(&inputs.pM->GetOrCreateDxilModule(),
@@ -143,8 +144,10 @@ void ReadOptsAndValidate(hlsl::options::MainArgs &mainArgs,
 HRESULT ValidateAndAssembleToContainer(AssembleInputs &inputs) {
   HRESULT valHR = S_OK;
 
-  // If we have debug info, this will be a clone of the module before debug info is stripped.
-  // This is used with internal validator to provide more useful error messages.
+  // If we have debug info and validation fails, this will be the module before
+  // debug info is stripped, read back from the module bitcode. This is used
+  // with internal validator to provide more useful error messages.
+  llvm::LLVMContext debugInfoContext;
   std::unique_ptr<llvm::Module> llvmModuleWithDebugInfo;
 
   CComPtr<IDxcValidator> pValidator;
@@ -159,14 +162,6 @@ HRESULT ValidateAndAssembleToContainer(AssembleInputs &inputs) {
                                "signed for use in release environments.\r\n");
       inputs.pDiag->Report(diagID);
     }
-    // If using the internal validator, we'll use the modules directly.
-    // In this case, we'll want to make a clone to avoid
-    // SerializeDxilContainerForModule stripping all the debug info. The debug
-    // info will be stripped from the orginal module, but preserved in the cloned
-    // module.
-    if (inputs.bDebugInfo) {
-      llvmModuleWithDebugInfo.reset(llvm::CloneModule(inputs.pM.get()));
-    }
   }
 
   // Verify validator version can validate this module
@@ -195,14 +190,38 @@ HRESULT ValidateAndAssembleToContainer(AssembleInputs &inputs) {
   // Important: in-place edit is required so the blob is reused and thus
   // dxil.dll can be released.
   if (bInternalValidator) {
-    IFT(RunInternalValidator(pValidator, inputs.pM.get(),
-                             llvmModuleWithDebugInfo.get(), inputs.pOutputContainerBlob,
+    // If using the internal validator, we'll use the modules directly, so the
+    // container bitcode is never read back; only the container parts are
+    // checked against the module. The debug module only improves error
+    // messages, so it is only materialized once validation has failed, rather
+    // than cloning the module for every compile.
+    IFT(RunInternalValidator(pValidator, inputs.pM.get(), nullptr,
+                             inputs.pOutputContainerBlob,
                              DxcValidatorFlags_InPlaceEdit, &pValResult));
+    IFT(pValResult->GetStatus(&valHR));
+    if (FAILED(valHR) && inputs.bDebugInfo && inputs.pModuleBitcode) {
+      llvm::MemoryBufferRef bitcode(
+          llvm::StringRef((const char *)inputs.pModuleBitcode->GetPtr(),
+                          inputs.pModuleBitcode->GetPtrSize()),
+          "");
+      llvm::ErrorOr<std::unique_ptr<llvm::Module>> debugModule =
+          llvm::parseBitcodeFile(bitcode, debugInfoContext);
+      if (debugModule) {
+        llvmModuleWithDebugInfo = std::move(debugModule.get());
+        pValResult.Release();
+        IFT(RunInternalValidator(pValidator, inputs.pM.get(),
+                                 llvmModuleWithDebugInfo.get(),
+                                 inputs.pOutputContainerBlob,
+                                 DxcValidatorFlags_InPlaceEdit, &pValResult));
+        IFT(pValResult->GetStatus(&valHR));
+      }
+    }
   } else {
+    hlsl::trace::ScopedEvent TraceValidation("ExternalValidation");
     IFT(pValidator->Validate(inputs.pOutputContainerBlob, DxcValidatorFlags_InPlaceEdit,
                              &pValResult));
+    IFT(pValResult->GetStatus(&valHR));
   }
-  IFT(pValResult->GetStatus(&valHR));
   if (inputs.pDiag) {
     if (FAILED(valHR)) {
       CComPtr<IDxcBlobEncoding> pErrors;
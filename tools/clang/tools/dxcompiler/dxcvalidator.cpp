@@ -18,6 +18,7 @@
 #include "dxc/HLSL/DxilValidation.h"
 
 #include "dxc/Support/Global.h"
+#include "llvm/ADT/Hashing.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MSFileSystem.h"
 #include "dxc/Support/microcom.h"
@@ -29,6 +30,10 @@
 #include "dxcetw.h"
 #endif
 
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
 #ifdef SUPPORT_QUERY_GIT_COMMIT_INFO
 #include "clang/Basic/Version.h"
 #endif // SUPPORT_QUERY_GIT_COMMIT_INFO
@@ -53,6 +58,54 @@ struct DiagRestore {
   }
 };
 
+// Holds standalone root signatures that have passed validation. Many shaders
+// share one root signature, and validators are created per call, so this is
+// kept for the process. Entries are keyed by a hash of the serialized bytes,
+// and the bytes are compared on a hit, so a hit is an exact content match;
+// only successes are kept, as failures must report diagnostics.
+//
+// Validation runs under the caller's allocator, so the cache switches to the
+// default allocator for anything that allocates or frees entries; lookups
+// neither allocate nor copy the blob.
+class ValidatedRootSignatureCache {
+private:
+  static const size_t MaxEntries = 256;
+  std::mutex m_mutex;
+  std::unordered_map<size_t, std::string> m_entries;
+
+  static ValidatedRootSignatureCache &Get() {
+    DxcThreadMalloc TM(nullptr);
+    static ValidatedRootSignatureCache cache;
+    return cache;
+  }
+
+  static size_t Hash(const void *pData, uint32_t size) {
+    const char *pBytes = (const char *)pData;
+    return hash_combine_range(pBytes, pBytes + size);
+  }
+
+public:
+  static bool Contains(const void *pData, uint32_t size) {
+    ValidatedRootSignatureCache &cache = Get();
+    size_t hash = Hash(pData, size);
+    std::lock_guard<std::mutex> lock(cache.m_mutex);
+    auto it = cache.m_entries.find(hash);
+    return it != cache.m_entries.end() && it->second.size() == size &&
+           0 == memcmp(it->second.data(), pData, size);
+  }
+
+  static void Insert(const void *pData, uint32_t size) {
+    ValidatedRootSignatureCache &cache = Get();
+    size_t hash = Hash(pData, size);
+    DxcThreadMalloc TM(nullptr);
+    std::lock_guard<std::mutex> lock(cache.m_mutex);
+    if (cache.m_entries.size() >= MaxEntries)
+      cache.m_entries.clear();
+    // A signature whose hash collides with an entry replaces it.
+    cache.m_entries[hash].assign((const char *)pData, size);
+  }
+};
+
 class DxcValidator : public IDxcValidator,
 #ifdef SUPPORT_QUERY_GIT_COMMIT_INFO
                      public IDxcVersionInfo2
@@ -265,9 +318,14 @@ HRESULT DxcValidator::RunRootSignatureValidation(
     // Container has shader part, make sure we have PSV.
     IFRBOOL(pPSVPart, DXC_E_MISSING_PART);
   }
+  const char *pRSData = GetDxilPartData(pRSPart);
+  if (!pProgramHeader &&
+      ValidatedRootSignatureCache::Contains(pRSData, pRSPart->PartSize)) {
+    return S_OK;
+  }
   try {
     RootSignatureHandle RSH;
-    RSH.LoadSerialized((const uint8_t*)GetDxilPartData(pRSPart), pRSPart->PartSize);
+    RSH.LoadSerialized((const uint8_t*)pRSData, pRSPart->PartSize);
     RSH.Deserialize();
     raw_stream_ostream DiagStream(pDiagStream);
     if (pProgramHeader) {
@@ -280,6 +338,7 @@ HRESULT DxcValidator::RunRootSignatureValidation(
     } else {
       IFRBOOL(VerifyRootSignature(RSH.GetDesc(), DiagStream, false),
               DXC_E_INCORRECT_ROOT_SIGNATURE);
+      ValidatedRootSignatureCache::Insert(pRSData, pRSPart->PartSize);
     }
   } catch(...) {
     return DXC_E_IR_VERIFICATION_FAILED;
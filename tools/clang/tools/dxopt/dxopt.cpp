@@ -24,8 +24,12 @@
 #include "dxc/Support/FileIOHelper.h"
 #include "dxc/Support/microcom.h"
 #include <comdef.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <limits>
+#include <thread>
 
 #include "llvm/Support/FileSystem.h"
 
@@ -47,6 +51,7 @@ enum class ProgramAction {
   PrintPasses,
   PrintPassesWithDetails,
   RunOptimizer,
+  RunBatch,
 };
 
 const wchar_t *STDIN_FILE_NAME = L"-";
@@ -193,10 +198,115 @@ static void ReadFileOpts(LPCWSTR pPassFileName, IDxcBlobEncoding **ppPassOpts, s
   pPassOpts->QueryInterface(ppPassOpts);
 }
 
+// Reads the input file names for batch mode, one per line.
+static void ReadBatchList(LPCWSTR pListFileName,
+                          std::vector<std::wstring> &inputs) {
+  CComPtr<IDxcBlob> pListBlob;
+  CComPtr<IDxcBlobUtf16> pList;
+  BlobFromFile(pListFileName, &pListBlob);
+  IFT(hlsl::DxcGetBlobAsUtf16(pListBlob, hlsl::GetGlobalHeapMalloc(), &pList));
+  LPCWSTR pCursor = pList->GetStringPointer();
+  while (*pCursor) {
+    LPCWSTR pLineStart = pCursor;
+    while (*pCursor && *pCursor != L'\n' && *pCursor != L'\r') {
+      ++pCursor;
+    }
+    std::wstring line(pLineStart, pCursor);
+    if (!line.empty() && line[0] != L'#') {
+      inputs.push_back(std::move(line));
+    }
+    while (*pCursor && (*pCursor == L'\n' || *pCursor == L'\r')) {
+      ++pCursor;
+    }
+  }
+}
+
+// Runs the same pass pipeline over every input in the list on a pool of
+// threads. Each RunOptimizer call works in an LLVMContext of its own, so
+// modules are processed independently; output is printed in input order.
+static int RunBatch(LPCWSTR pListFileName, LPCWSTR pOutSuffix,
+                    unsigned threadCount, LPCWSTR *optArgs,
+                    UINT32 optArgCount) {
+  std::vector<std::wstring> inputs;
+  ReadBatchList(pListFileName, inputs);
+
+  struct BatchResult {
+    HRESULT hr = E_FAIL;
+    CComPtr<IDxcBlob> pOutputModule;
+    CComPtr<IDxcBlobEncoding> pOutputText;
+    double ms = 0;
+  };
+  std::vector<BatchResult> results(inputs.size());
+  auto optimizeOne = [&](unsigned i) {
+    BatchResult &result = results[i];
+    auto t_start = std::chrono::steady_clock::now();
+    try {
+      CComPtr<IDxcOptimizer> pOptimizer;
+      CComPtr<IDxcBlob> pBlob;
+      IFT(g_DxcSupport.CreateInstance(CLSID_DxcOptimizer, &pOptimizer));
+      BlobFromFile(inputs[i].c_str(), &pBlob);
+      result.hr = pOptimizer->RunOptimizer(pBlob, optArgs, optArgCount,
+                                           &result.pOutputModule,
+                                           &result.pOutputText);
+    } catch (const ::hlsl::Exception &hlslException) {
+      result.hr = hlslException.hr;
+    } catch (std::bad_alloc &) {
+      result.hr = E_OUTOFMEMORY;
+    }
+    auto t_end = std::chrono::steady_clock::now();
+    result.ms =
+        std::chrono::duration<double, std::milli>(t_end - t_start).count();
+  };
+
+  if (threadCount == 0)
+    threadCount = std::thread::hardware_concurrency();
+  threadCount = std::max(1u, std::min<unsigned>(threadCount, inputs.size()));
+
+  auto t_start = std::chrono::steady_clock::now();
+  std::atomic<unsigned> nextInput(0);
+  std::vector<std::thread> threads;
+  for (unsigned i = 0; i < threadCount; i++) {
+    threads.emplace_back([&]() {
+      for (unsigned n = nextInput++; n < inputs.size(); n = nextInput++)
+        optimizeOne(n);
+    });
+  }
+  for (auto &th : threads)
+    th.join();
+  auto t_end = std::chrono::steady_clock::now();
+  double wallMs =
+      std::chrono::duration<double, std::milli>(t_end - t_start).count();
+
+  int retVal = 0;
+  unsigned failedCount = 0;
+  double totalMs = 0;
+  for (unsigned i = 0; i < inputs.size(); i++) {
+    BatchResult &result = results[i];
+    totalMs += result.ms;
+    wprintf(L"; %s: %.3f ms\n", inputs[i].c_str(), result.ms);
+    if (FAILED(result.hr)) {
+      wprintf(L"; failed - error code 0x%08x.\n", (unsigned)result.hr);
+      ++failedCount;
+      retVal = 1;
+      continue;
+    }
+    std::wstring outFileName;
+    if (pOutSuffix && *pOutSuffix)
+      outFileName = inputs[i] + pOutSuffix;
+    PrintOptOutput(outFileName.c_str(), result.pOutputModule,
+                   result.pOutputText);
+  }
+  wprintf(L"; modules: %u, failed: %u, threads: %u, optimize time: %.3f ms, "
+          L"wall time: %.3f ms\n",
+          (unsigned)inputs.size(), failedCount, threadCount, totalMs, wallMs);
+  return retVal;
+}
+
 static void PrintHelp() {
   wprintf(L"%s",
     L"Performs optimizations on a bitcode file by running a sequence of passes.\n\n"
-    L"dxopt [-? | -passes | -pass-details | -pf [PASS-FILE] | [-o=OUT-FILE] | IN-FILE OPT-ARGUMENTS ...]\n\n"
+    L"dxopt [-? | -passes | -pass-details | -pf [PASS-FILE] | [-o=OUT-FILE] | IN-FILE OPT-ARGUMENTS ...]\n"
+    L"dxopt -batch LIST-FILE [-j N] [-pf [PASS-FILE]] [-o=OUT-SUFFIX] OPT-ARGUMENTS ...\n\n"
     L"Arguments:\n"
     L"  -?  Displays this help message\n"
     L"  -passes        Displays a list of pass names\n"
@@ -205,6 +315,14 @@ static void PrintHelp() {
     L"  -o=OUT-FILE    Output file for processed module\n"
     L"  IN-FILE        File with with bitcode to optimize\n"
     L"  OPT-ARGUMENTS  One or more passes to run in sequence\n"
+    L"  -time-passes   Reports the time taken by each pass\n"
+    L"\n"
+    L"Batch mode:\n"
+    L"  -batch LIST-FILE  Runs the passes over each file listed in LIST-FILE, one\n"
+    L"                    per line, in parallel\n"
+    L"  -j N              Number of threads to use; defaults to one per core\n"
+    L"  -o=OUT-SUFFIX     Writes each processed module to its input name plus\n"
+    L"                    OUT-SUFFIX\n"
     L"\n"
     L"Text that is traced during optimization is written to the standard output.\n"
   );
@@ -226,6 +344,8 @@ int __cdecl wmain(int argc, const wchar_t **argv_) {
     LPCWSTR externalLib = nullptr;
     LPCWSTR externalFn = nullptr;
     LPCWSTR passFileName = nullptr;
+    LPCWSTR batchFileName = nullptr;
+    unsigned threadCount = 0;
     const wchar_t **optArgs = nullptr;
     UINT32 optArgCount = 0;
 
@@ -265,9 +385,32 @@ int __cdecl wmain(int argc, const wchar_t **argv_) {
         }
         passFileName = argv_[argIdx];
       }
+      else if (wcsieqopt(arg, L"batch")) {
+        ++argIdx;
+        if (argIdx == argc) {
+          PrintHelp();
+          return 1;
+        }
+        batchFileName = argv_[argIdx];
+        action = ProgramAction::RunBatch;
+      }
+      else if (wcsieqopt(arg, L"j")) {
+        ++argIdx;
+        if (argIdx == argc) {
+          PrintHelp();
+          return 1;
+        }
+        threadCount = wcstoul(argv_[argIdx], nullptr, 10);
+      }
       else if (wcsistarts(arg, L"-o=")) {
         outFileName = argv_[argIdx] + 3;
       }
+      else if (action == ProgramAction::RunBatch) {
+        // The remaining arguments are optimizer args.
+        optArgs = argv_ + argIdx;
+        optArgCount = argc - argIdx;
+        break;
+      }
       else {
         action = ProgramAction::RunOptimizer;
         // See if arg is file input specifier.
@@ -329,6 +472,12 @@ int __cdecl wmain(int argc, const wchar_t **argv_) {
       IFT(pOptimizer->RunOptimizer(pBlob, optArgs, optArgCount, &pOutputModule, &pOutputText));
       PrintOptOutput(outFileName, pOutputModule, pOutputText);
       break;
+    case ProgramAction::RunBatch:
+      pStage = "Batch optimizer processing";
+      ReadFileOpts(passFileName, &pPassOpts, passes, &optArgs, &optArgCount);
+      retVal = RunBatch(batchFileName, outFileName, threadCount, optArgs,
+                        optArgCount);
+      break;
     }
   } catch (const ::hlsl::Exception &hlslException) {
     try {
@@ -1195,7 +1195,7 @@ HRESULT DxcIndex::ParseTranslationUnit(
       clang_disposeTranslationUnit(tu);
       return E_OUTOFMEMORY;
     }
-    localTU->Initialize(tu);
+    localTU->Initialize(tu, std::move(msf));
     *pTranslationUnit = localTU.Detach();
 
     return S_OK;
@@ -1519,14 +1519,7 @@ DxcTranslationUnit::DxcTranslationUnit() : m_tu(nullptr)
 
 DxcTranslationUnit::~DxcTranslationUnit() {
   if (m_tu != nullptr) {
-    // TODO: until an interface to file access is defined and implemented, simply fall back to pure Win32/CRT calls.
-    // Also, note that this can throw / fail in a destructor, which is a big no-no.
-    ::llvm::sys::fs::MSFileSystem* msfPtr;
-    CreateMSFileSystemForDisk(&msfPtr);
-    assert(msfPtr != nullptr);
-    std::unique_ptr<::llvm::sys::fs::MSFileSystem> msf(msfPtr);
-
-    ::llvm::sys::fs::AutoPerThreadSystem pts(msf.get());
+    ::llvm::sys::fs::AutoPerThreadSystem pts(m_msf.get());
     assert(!pts.error_code());
 
     clang_disposeTranslationUnit(m_tu);
@@ -1534,9 +1527,10 @@ DxcTranslationUnit::~DxcTranslationUnit() {
   }
 }
 
-void DxcTranslationUnit::Initialize(CXTranslationUnit tu)
+void DxcTranslationUnit::Initialize(CXTranslationUnit tu, std::unique_ptr<::llvm::sys::fs::MSFileSystem> msf)
 {
   m_tu = tu;
+  m_msf = std::move(msf);
 }
 
 _Use_decl_annotations_
@@ -1668,8 +1662,13 @@ HRESULT DxcTranslationUnit::Reparse(
   DxcThreadMalloc TM(m_pMalloc);
   hr = SetupUnsavedFiles(unsaved_files, num_unsaved_files, &local_unsaved_files);
   if (FAILED(hr)) return hr;
-  int reparseResult = clang_reparseTranslationUnit(
-    m_tu, num_unsaved_files, local_unsaved_files, clang_defaultReparseOptions(m_tu));
+  int reparseResult;
+  {
+    ::llvm::sys::fs::AutoPerThreadSystem pts(m_msf.get());
+    reparseResult = pts.error_code()
+      ? 1
+      : clang_reparseTranslationUnit(m_tu, num_unsaved_files, local_unsaved_files, clang_defaultReparseOptions(m_tu));
+  }
   CleanupUnsavedFiles(local_unsaved_files, num_unsaved_files);
   return reparseResult == 0 ? S_OK : E_FAIL;
 }
@@ -1858,8 +1857,13 @@ HRESULT DxcTranslationUnit::CodeCompleteAt(
   if (FAILED(hr))
     return hr;
 
-  CXCodeCompleteResults *results = clang_codeCompleteAt(
-      m_tu, fileName, line, column, files, numUnsavedFiles, options);
+  CXCodeCompleteResults *results = nullptr;
+  {
+    ::llvm::sys::fs::AutoPerThreadSystem pts(m_msf.get());
+    if (!pts.error_code())
+      results = clang_codeCompleteAt(
+          m_tu, fileName, line, column, files, numUnsavedFiles, options);
+  }
 
   CleanupUnsavedFiles(files, numUnsavedFiles);
 
@@ -17,6 +17,9 @@
 #include "dxc/dxcapi.internal.h"
 #include "dxc/Support/microcom.h"
 #include "dxc/Support/DxcLangExtensionsHelper.h"
+#include <memory>
+
+namespace llvm { namespace sys { namespace fs { class MSFileSystem; } } }
 
 // Forward declarations.
 class DxcCursor;
@@ -303,6 +306,9 @@ class DxcTranslationUnit : public IDxcTranslationUnit
 private:
     DXC_MICROCOM_TM_REF_FIELDS()
     CXTranslationUnit m_tu;
+    // File system the translation unit was parsed with; reused to reparse,
+    // complete and dispose it.
+    std::unique_ptr<::llvm::sys::fs::MSFileSystem> m_msf;
 public:
     DXC_MICROCOM_TM_ADDREF_RELEASE_IMPL()
     HRESULT STDMETHODCALLTYPE QueryInterface(REFIID iid, void** ppvObject) override
@@ -312,7 +318,7 @@ public:
 
     DxcTranslationUnit();
     ~DxcTranslationUnit();
-    void Initialize(CXTranslationUnit tu);
+    void Initialize(CXTranslationUnit tu, std::unique_ptr<::llvm::sys::fs::MSFileSystem> msf);
 
     HRESULT STDMETHODCALLTYPE GetCursor(_Outptr_ IDxcCursor** pCursor) override;
     HRESULT STDMETHODCALLTYPE Tokenize(
@@ -547,6 +547,7 @@ public:
   TEST_METHOD(Intersections)
   TEST_METHOD(GapFilling)
   TEST_METHOD(Allocate)
+  TEST_METHOD(RepeatedFind)
 
   void InitScenarios() {
     struct P {
@@ -766,3 +767,54 @@ TEST_F(AllocatorTest, Allocate) {
     TestSizesFn();
   }
 }
+
+TEST_F(AllocatorTest, RepeatedFind) {
+  WEX::TestExecution::SetVerifyOutput verifySettings(WEX::TestExecution::VerifyOutputSettings::LogOnlyFailures);
+
+  // Fill a range with single spans separated by gaps of varying sizes, then
+  // repeatedly find and insert spans of a few sizes, as register allocation
+  // does. Each result must match a first-fit search over the whole range.
+  const unsigned Max = 4095;
+  std::vector<bool> used(Max + 1, false);
+  std::vector<Element> elements;
+  elements.reserve(Max + 1);
+  Allocator alloc(0, Max);
+  std::mt19937 gen(7);
+  for (unsigned pos = 0; pos <= Max; pos += 2 + (gen() % 4)) {
+    elements.emplace_back(elements.size(), pos, pos);
+    VERIFY_IS_NULL(alloc.Insert(&elements.back(), pos, pos));
+    used[pos] = true;
+  }
+
+  auto FirstFit = [&](unsigned size, unsigned &pos) {
+    unsigned run = 0;
+    for (unsigned i = 0; i <= Max; ++i) {
+      run = used[i] ? 0 : run + 1;
+      if (run == size) {
+        pos = i + 1 - size;
+        return true;
+      }
+    }
+    return false;
+  };
+
+  static const unsigned sizes[] = { 3, 1, 3, 2, 4, 3, 1, 2 };
+  for (unsigned i = 0; elements.size() < elements.capacity(); ++i) {
+    unsigned size = sizes[i % _countof(sizes)];
+    unsigned expected = 0;
+    bool expectFound = FirstFit(size, expected);
+    unsigned pos = 0;
+    bool found = alloc.Find(size, pos);
+    VERIFY_ARE_EQUAL(expectFound, found);
+    if (!found) {
+      if (size == 1)
+        break;
+      continue;
+    }
+    VERIFY_ARE_EQUAL(expected, pos);
+    elements.emplace_back(elements.size(), pos, pos + size - 1);
+    VERIFY_IS_NULL(alloc.Insert(&elements.back(), pos, pos + size - 1));
+    for (unsigned j = pos; j < pos + size; ++j)
+      used[j] = true;
+  }
+}
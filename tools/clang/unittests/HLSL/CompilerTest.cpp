@@ -21,6 +21,8 @@
 #include <sstream>
 #include <algorithm>
 #include <cfloat>
+#include <thread>
+#include <mutex>
 #include "dxc/DxilContainer/DxilContainer.h"
 #include "dxc/Support/WinIncludes.h"
 #include "dxc/dxcapi.h"
@@ -45,6 +47,8 @@
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MSFileSystem.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/xxhash.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/ADT/StringSwitch.h"
 
@@ -122,6 +126,8 @@ public:
   TEST_METHOD(CompileWhenEmptyThenFails)
   TEST_METHOD(CompileWhenIncorrectThenFails)
   TEST_METHOD(CompileWhenWorksThenDisassembleWorks)
+  TEST_METHOD(DisassembleWhenNonAsciiThenUtf8Preserved)
+  TEST_METHOD(CompileWhenContentHashThenMatchesObject)
   TEST_METHOD(CompileWhenDebugWorksThenStripDebug)
   TEST_METHOD(CompileWhenWorksThenAddRemovePrivate)
   TEST_METHOD(CompileThenAddCustomDebugName)
@@ -130,6 +136,7 @@ public:
   TEST_METHOD(CompileWhenIncludeThenLoadInvoked)
   TEST_METHOD(CompileWhenIncludeThenLoadUsed)
   TEST_METHOD(CompileWhenIncludeAbsoluteThenLoadAbsolute)
+  TEST_METHOD(CompileWhenSharedAcrossThreadsThenResultsMatch)
   TEST_METHOD(CompileWhenIncludeLocalThenLoadRelative)
   TEST_METHOD(CompileWhenIncludeSystemThenLoadNotRelative)
   TEST_METHOD(CompileWhenIncludeSystemMissingThenLoadAttempt)
@@ -773,6 +780,90 @@ TEST_F(CompilerTest, CompileWhenWorksThenDisassembleWorks) {
   // WEX::Logging::Log::Comment(disassembleStringW.m_psz);
 }
 
+TEST_F(CompilerTest, DisassembleWhenNonAsciiThenUtf8Preserved) {
+  CComPtr<IDxcCompiler> pCompiler;
+  CComPtr<IDxcOperationResult> pResult;
+  CComPtr<IDxcBlobEncoding> pSource;
+
+  // The debug name is printed verbatim, so it carries non-ASCII text into
+  // the disassembly.
+  VERIFY_SUCCEEDED(CreateCompiler(&pCompiler));
+  CreateBlobFromText("float4 main() : SV_Target { return 0; }", &pSource);
+  LPCWSTR args[] = { L"-Fd", L"caf\u00e9.pdb" };
+  VERIFY_SUCCEEDED(pCompiler->Compile(pSource, L"source.hlsl", L"main",
+                                      L"ps_6_0", args, _countof(args),
+                                      nullptr, 0, nullptr, &pResult));
+  HRESULT result;
+  VERIFY_SUCCEEDED(pResult->GetStatus(&result));
+  VERIFY_SUCCEEDED(result);
+
+  CComPtr<IDxcBlob> pProgram;
+  VERIFY_SUCCEEDED(pResult->GetResult(&pProgram));
+
+  // IDxcCompiler3 returns the disassembly as UTF-8 text.
+  CComPtr<IDxcCompiler3> pCompiler3;
+  VERIFY_SUCCEEDED(pCompiler.QueryInterface(&pCompiler3));
+  DxcBuffer buffer = { pProgram->GetBufferPointer(),
+                       pProgram->GetBufferSize(), 0 };
+  CComPtr<IDxcResult> pDisassembleResult;
+  VERIFY_SUCCEEDED(pCompiler3->Disassemble(&buffer,
+                                           IID_PPV_ARGS(&pDisassembleResult)));
+  CComPtr<IDxcBlobUtf8> pText;
+  VERIFY_SUCCEEDED(pDisassembleResult->GetOutput(DXC_OUT_DISASSEMBLY,
+                                                 IID_PPV_ARGS(&pText), nullptr));
+  BOOL known;
+  UINT32 codePage;
+  VERIFY_SUCCEEDED(pText->GetEncoding(&known, &codePage));
+  VERIFY_IS_TRUE(known);
+  VERIFY_ARE_EQUAL(CP_UTF8, codePage);
+  std::string text(pText->GetStringPointer(), pText->GetStringLength());
+  VERIFY_ARE_EQUAL(strlen(pText->GetStringPointer()), text.size());
+  VERIFY_ARE_NOT_EQUAL(std::string::npos,
+                       text.find("; shader debug name: caf\xc3\xa9.pdb\n"));
+
+  // IDxcCompiler::Disassemble produces the same text.
+  CComPtr<IDxcBlobEncoding> pLegacyText;
+  VERIFY_SUCCEEDED(pCompiler->Disassemble(pProgram, &pLegacyText));
+  VERIFY_ARE_EQUAL(text, BlobToUtf8(pLegacyText));
+}
+
+TEST_F(CompilerTest, CompileWhenContentHashThenMatchesObject) {
+  CComPtr<IDxcCompiler3> pCompiler;
+  VERIFY_SUCCEEDED(m_dllSupport.CreateInstance(CLSID_DxcCompiler, &pCompiler));
+  const char *source = "float4 main() : SV_Target { return 0; }";
+  DxcBuffer buffer = { source, strlen(source), CP_UTF8 };
+
+  // The content hash is only produced when requested.
+  CComPtr<IDxcResult> pResult;
+  LPCWSTR args[] = { L"-E", L"main", L"-T", L"ps_6_0" };
+  VERIFY_SUCCEEDED(pCompiler->Compile(&buffer, args, _countof(args), nullptr,
+                                      IID_PPV_ARGS(&pResult)));
+  HRESULT status;
+  VERIFY_SUCCEEDED(pResult->GetStatus(&status));
+  VERIFY_SUCCEEDED(status);
+  VERIFY_IS_FALSE(pResult->HasOutput(DXC_OUT_CONTENT_HASH));
+
+  pResult.Release();
+  LPCWSTR hashArgs[] = { L"-E", L"main", L"-T", L"ps_6_0", L"-Fch", L"hash.bin" };
+  VERIFY_SUCCEEDED(pCompiler->Compile(&buffer, hashArgs, _countof(hashArgs),
+                                      nullptr, IID_PPV_ARGS(&pResult)));
+  VERIFY_SUCCEEDED(pResult->GetStatus(&status));
+  VERIFY_SUCCEEDED(status);
+  VERIFY_IS_TRUE(pResult->HasOutput(DXC_OUT_CONTENT_HASH));
+
+  CComPtr<IDxcBlob> pObject;
+  CComPtr<IDxcBlob> pHash;
+  CComPtr<IDxcBlobUtf16> pHashName;
+  VERIFY_SUCCEEDED(pResult->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(&pObject), nullptr));
+  VERIFY_SUCCEEDED(pResult->GetOutput(DXC_OUT_CONTENT_HASH, IID_PPV_ARGS(&pHash), &pHashName));
+  VERIFY_ARE_EQUAL_WSTR(L"hash.bin", pHashName->GetStringPointer());
+  VERIFY_ARE_EQUAL(sizeof(uint64_t), pHash->GetBufferSize());
+  uint64_t expected = llvm::xxHash64(llvm::StringRef(
+      (const char *)pObject->GetBufferPointer(), pObject->GetBufferSize()));
+  VERIFY_ARE_EQUAL(expected,
+                   llvm::support::endian::read64le(pHash->GetBufferPointer()));
+}
+
 #ifdef _WIN32 // Container builder unsupported
 
 TEST_F(CompilerTest, CompileWhenDebugWorksThenStripDebug) {
@@ -1614,6 +1705,124 @@ TEST_F(CompilerTest, CompileWhenNoMemThenOOM) {
 }
 #endif
 
+// Serializes an InstrumentedHeapMalloc, which is not thread-safe, so that it
+// can back a compiler instance shared across threads.
+struct SynchronizedMalloc : public IMalloc {
+private:
+  InstrumentedHeapMalloc &m_Inner;
+  std::mutex m_Mutex;
+public:
+  SynchronizedMalloc(InstrumentedHeapMalloc &Inner) : m_Inner(Inner) {}
+  ULONG STDMETHODCALLTYPE AddRef() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Inner.AddRef();
+  }
+  ULONG STDMETHODCALLTYPE Release() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Inner.Release();
+  }
+  STDMETHODIMP QueryInterface(REFIID iid, void** ppvObject) {
+    return DoBasicQueryInterface<IMalloc>(this, iid, ppvObject);
+  }
+  virtual void *STDMETHODCALLTYPE Alloc(_In_ SIZE_T cb) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Inner.Alloc(cb);
+  }
+  virtual void *STDMETHODCALLTYPE Realloc(_In_opt_ void *pv, _In_ SIZE_T cb) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Inner.Realloc(pv, cb);
+  }
+  virtual void STDMETHODCALLTYPE Free(_In_opt_ void *pv) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Inner.Free(pv);
+  }
+  virtual SIZE_T STDMETHODCALLTYPE GetSize(_In_opt_ _Post_writable_byte_size_(return) void *pv) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Inner.GetSize(pv);
+  }
+  virtual int STDMETHODCALLTYPE DidAlloc(_In_opt_ void *pv) {
+    return -1; // don't know
+  }
+  virtual void STDMETHODCALLTYPE HeapMinimize(void) {}
+};
+
+TEST_F(CompilerTest, CompileWhenSharedAcrossThreadsThenResultsMatch) {
+  CComPtr<IDxcBlobEncoding> pSource;
+  CreateBlobFromText(
+    "#include \"helper.h\"\r\n"
+    "float4 main(float4 a : A) : SV_Target { return sin(a) * SCALE; }",
+    &pSource);
+
+  // The instance malloc sees every allocation made on behalf of the shared
+  // compiler, from all threads.
+  InstrumentedHeapMalloc InstrMalloc;
+  InstrMalloc.ResetHeap();
+  SynchronizedMalloc SyncMalloc(InstrMalloc);
+  VERIFY_IS_TRUE(m_dllSupport.HasCreateWithMalloc());
+  ULONG initialRefCount = InstrMalloc.GetRefCount();
+  CComPtr<IDxcCompiler> pCompiler;
+  VERIFY_SUCCEEDED(m_dllSupport.CreateInstance2(&SyncMalloc, CLSID_DxcCompiler, &pCompiler));
+
+  // Each call gets its own include handler; the compiler is shared.
+  auto compileOnce = [&](IDxcBlob **ppProgram) -> HRESULT {
+    CComPtr<TestIncludeHandler> pInclude =
+        new TestIncludeHandler(m_dllSupport);
+    pInclude->CallResults.emplace_back("#define SCALE 2");
+    CComPtr<IDxcOperationResult> pResult;
+    HRESULT hr = pCompiler->Compile(pSource, L"source.hlsl", L"main",
+      L"ps_6_0", nullptr, 0, nullptr, 0, pInclude, &pResult);
+    HRESULT status = E_FAIL;
+    if (SUCCEEDED(hr))
+      hr = pResult->GetStatus(&status);
+    if (SUCCEEDED(hr))
+      hr = status;
+    if (SUCCEEDED(hr))
+      hr = pResult->GetResult(ppProgram);
+    return hr;
+  };
+
+  CComPtr<IDxcBlob> pExpected;
+  VERIFY_SUCCEEDED(compileOnce(&pExpected));
+
+  const unsigned ThreadCount = 4;
+  const unsigned CompilesPerThread = 8;
+  std::vector<HRESULT> results(ThreadCount * CompilesPerThread, E_FAIL);
+  std::vector<CComPtr<IDxcBlob>> programs(results.size());
+  std::vector<std::thread> threads;
+  for (unsigned t = 0; t < ThreadCount; ++t) {
+    threads.emplace_back([&, t]() {
+      for (unsigned i = 0; i < CompilesPerThread; ++i) {
+        unsigned n = t * CompilesPerThread + i;
+        results[n] = compileOnce(&programs[n]);
+      }
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  for (unsigned n = 0; n < results.size(); ++n) {
+    VERIFY_SUCCEEDED(results[n]);
+    VERIFY_ARE_EQUAL(pExpected->GetBufferSize(), programs[n]->GetBufferSize());
+    VERIFY_ARE_EQUAL(0, memcmp(pExpected->GetBufferPointer(),
+                               programs[n]->GetBufferPointer(),
+                               pExpected->GetBufferSize()));
+  }
+
+  pExpected.Release();
+  programs.clear();
+  pCompiler.Release();
+
+#if _ITERATOR_DEBUG_LEVEL==0
+  // Nothing allocated by concurrent calls may outlive the instance.
+  if (InstrMalloc.GetSize() != 0) {
+    WEX::Logging::Log::Comment(L"Memory leak(s) detected");
+    InstrMalloc.DumpLeaks();
+    VERIFY_IS_TRUE(0 == InstrMalloc.GetSize());
+  }
+#endif
+  VERIFY_ARE_EQUAL(initialRefCount, InstrMalloc.GetRefCount());
+}
+
 TEST_F(CompilerTest, CompileWhenShaderModelMismatchAttributeThenFail) {
   CComPtr<IDxcCompiler> pCompiler;
   CComPtr<IDxcOperationResult> pResult;
@@ -97,6 +97,7 @@ public:
   TEST_METHOD(CompileAS_CheckPSV0)
   TEST_METHOD(CompileWhenOkThenCheckRDAT)
   TEST_METHOD(CompileWhenOkThenCheckRDAT2)
+  TEST_METHOD(FindInRDATWhenNamesUnreadableThenSkipped)
   TEST_METHOD(CompileWhenOkThenCheckReflection1)
   TEST_METHOD(DxcUtils_CreateReflection)
   TEST_METHOD(CompileWhenOKThenIncludesFeatureInfo)
@@ -892,9 +893,12 @@ TEST_F(DxilContainerTest, CompileWhenOkThenCheckRDAT) {
       FunctionTableReader *funcTableReader = context.GetFunctionTableReader();
       ResourceTableReader *resTableReader = context.GetResourceTableReader();
       VERIFY_ARE_EQUAL(funcTableReader->GetNumFunctions(), 4);
+      VERIFY_ARE_EQUAL(funcTableReader->FindFunction("function_missing"),
+                       funcTableReader->GetNumFunctions());
       std::string str("function");
       for (uint32_t j = 0; j < funcTableReader->GetNumFunctions(); ++j) {
         FunctionReader funcReader = funcTableReader->GetItem(j);
+        VERIFY_ARE_EQUAL(funcTableReader->FindFunction(funcReader.GetName()), j);
         std::string funcName(funcReader.GetUnmangledName());
         VERIFY_IS_TRUE(str.compare(funcName.substr(0,8)) == 0);
         std::string cur_str = str;
@@ -1023,6 +1027,32 @@ TEST_F(DxilContainerTest, CompileWhenOkThenCheckRDAT) {
   IFTBOOLMSG(blobFound, E_FAIL, "failed to find RDAT blob after compiling");
 }
 
+TEST_F(DxilContainerTest, FindInRDATWhenNamesUnreadableThenSkipped) {
+  using namespace hlsl::RDAT;
+  RuntimeDataFunctionInfo functions[2] = {};
+  functions[0].Name = 0;
+  functions[1].Name = 100; // Past the end of the string table.
+  const char names[] = "a";
+  StringTableReader noStrings;
+  StringTableReader strings(names, sizeof(names));
+  RuntimeDataContext context = {};
+  FunctionTableReader funcTableReader;
+  funcTableReader.SetContext(&context);
+
+  // Without a string table, no row has a name to match.
+  context.pStringTableReader = &noStrings;
+  funcTableReader.SetFunctionInfo((const char *)functions, _countof(functions),
+                                  sizeof(RuntimeDataFunctionInfo));
+  VERIFY_ARE_EQUAL(funcTableReader.FindFunction("a"), 2u);
+
+  // A name offset out of range skips that row only.
+  context.pStringTableReader = &strings;
+  funcTableReader.SetFunctionInfo((const char *)functions, _countof(functions),
+                                  sizeof(RuntimeDataFunctionInfo));
+  VERIFY_ARE_EQUAL(funcTableReader.FindFunction("a"), 0u);
+  VERIFY_ARE_EQUAL(funcTableReader.FindFunction("b"), 2u);
+}
+
 TEST_F(DxilContainerTest, CompileWhenOkThenCheckRDAT2) {
   if (m_ver.SkipDxilVersion(1, 3)) return;
   // This is a case when the user of resource is a constant, not instruction.
@@ -26,6 +26,7 @@
 #include <algorithm>
 #include <cfloat>
 #include "dxc/DxilContainer/DxilContainer.h"
+#include "dxc/DxilPIXPasses/DxilPIXDebugTrace.h"
 #include "dxc/Support/WinIncludes.h"
 #include "dxc/dxcapi.h"
 #include "dxc/dxcpix.h"
@@ -163,6 +164,7 @@ public:
   TEST_METHOD(DiaLoadBitcodePlusExtraData)
   TEST_METHOD(DiaCompileArgs)
   TEST_METHOD(PixDebugCompileInfo)
+  TEST_METHOD(PixDebugCompactTraceRoundTrip)
 
   dxc::DxcDllSupport m_dllSupport;
 
@@ -1304,5 +1306,64 @@ TEST_F(PixTest, PixDebugCompileInfo) {
   VERIFY_ARE_EQUAL(std::wstring(profile), std::wstring(hlslTarget));
 }
 
+TEST_F(PixTest, PixDebugCompactTraceRoundTrip) {
+  using namespace pix_dxil;
+
+  // Build a trace in the standard format: two interleaved invocations, with
+  // steps of every size and a start marker in between.
+  std::vector<uint32_t> Standard;
+  auto AddMarker = [&](uint32_t UID) {
+    DebugShaderModifierRecordHeader marker = {};
+    marker.Header.Details.SizeDwords =
+        DebugShaderModifierRecordPayloadSizeDwords(sizeof(marker));
+    marker.Header.Details.Type =
+        DebugShaderModifierRecordTypeInvocationStartMarker;
+    Standard.push_back(marker.Header.u32Header);
+    Standard.push_back(UID);
+  };
+  auto AddStep = [&](uint32_t UID, DebugShaderModifierRecordType Type,
+                     uint32_t InstNum, std::vector<uint32_t> Payload) {
+    DebugShaderModifierRecordDXILStepBase step = {};
+    step.Header.Details.SizeDwords = DebugShaderModifierRecordPayloadSizeDwords(
+        sizeof(step) + Payload.size() * sizeof(uint32_t));
+    step.Header.Details.Type = Type;
+    Standard.push_back(step.Header.u32Header);
+    Standard.push_back(UID);
+    Standard.push_back(InstNum);
+    Standard.insert(Standard.end(), Payload.begin(), Payload.end());
+  };
+
+  AddMarker(0);
+  AddStep(0, DebugShaderModifierRecordTypeDXILStepFloat, 1, {0x3f800000, 7 << 16});
+  AddStep(0, DebugShaderModifierRecordTypeDXILStepUint32, 2, {42, 8 << 16});
+  AddStep(0, DebugShaderModifierRecordTypeDXILStepVoid, 3, {});
+  AddMarker(64);
+  AddStep(64, DebugShaderModifierRecordTypeDXILStepUint64, 1, {1, 2, 9 << 16});
+  AddStep(0, DebugShaderModifierRecordTypeDXILStepDouble, 4, {3, 4, (10 << 16) | 1});
+  AddStep(0, DebugShaderModifierRecordTypeDXILStepVoid, 0xFFFFFF, {});
+
+  std::vector<uint32_t> Compact;
+  VERIFY_IS_TRUE(EncodeDebugShaderModifierRecords(Standard.data(),
+                                                  Standard.size(), Compact));
+  VERIFY_IS_TRUE(Compact.size() < Standard.size());
+
+  std::vector<uint32_t> Decoded;
+  VERIFY_IS_TRUE(DecodeDebugShaderModifierRecords(Compact.data(),
+                                                  Compact.size(), Decoded));
+  VERIFY_IS_TRUE(Standard == Decoded);
+
+  // A truncated block is reported as malformed.
+  std::vector<uint32_t> Truncated;
+  VERIFY_IS_FALSE(DecodeDebugShaderModifierRecords(
+      Compact.data(), Compact.size() - 1, Truncated));
+
+  // Instruction offsets that don't fit in a compact step are rejected.
+  Standard.clear();
+  AddStep(0, DebugShaderModifierRecordTypeDXILStepVoid, 0x1000000, {});
+  Compact.clear();
+  VERIFY_IS_FALSE(EncodeDebugShaderModifierRecords(Standard.data(),
+                                                   Standard.size(), Compact));
+}
+
 
 #endif
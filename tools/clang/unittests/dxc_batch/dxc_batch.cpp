@@ -33,8 +33,10 @@
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <comdef.h>
+#include <mutex>
 #include <thread>
 #include <unordered_map>
 
@@ -68,6 +70,7 @@ class DxcContext {
 private:
   DxcOpts &m_Opts;
   DxcDllSupport &m_dxcSupport;
+  CComPtr<IDxcIncludeHandler> m_pIncludeHandler;
 
   int ActOnBlob(IDxcBlob *pBlob);
   int ActOnBlob(IDxcBlob *pBlob, IDxcBlob *pDebugBlob, LPCWSTR pDebugBlobName);
@@ -85,6 +88,11 @@ public:
   DxcContext(DxcOpts &Opts, DxcDllSupport &dxcSupport)
       : m_Opts(Opts), m_dxcSupport(dxcSupport) {}
 
+  // Use pIncludeHandler instead of a new include handler for each compile.
+  void SetIncludeHandler(IDxcIncludeHandler *pIncludeHandler) {
+    m_pIncludeHandler = pIncludeHandler;
+  }
+
   int Compile(llvm::StringRef path, bool bLibLink);
   int DumpBinary();
   void Preprocess();
@@ -121,7 +129,8 @@ static void PrintHlslException(const ::hlsl::Exception &hlslException,
 
 static int Compile(llvm::StringRef command, DxcDllSupport &dxcSupport,
                    llvm::StringRef path, bool bLinkLib,
-                   std::string &errorString) {
+                   std::string &errorString,
+                   IDxcIncludeHandler *pIncludeHandler = nullptr) {
                    //llvm::raw_string_ostream &errorStream) {
   const OptTable *optionTable = getHlslOptTable();
   llvm::SmallVector<llvm::StringRef, 4> args;
@@ -141,6 +150,7 @@ static int Compile(llvm::StringRef command, DxcDllSupport &dxcSupport,
   if (0 == retVal) {
     try {
       DxcContext context(dxcOpts, dxcSupport);
+      context.SetIncludeHandler(pIncludeHandler);
       // TODO: implement all other actions.
       if (!dxcOpts.Preprocess.empty()) {
         context.Preprocess();
@@ -557,6 +567,63 @@ public:
   }
 };
 
+// Include handler shared by all permutations of a shader. Each file name the
+// compiler asks for, including failed probes of include directories, is only
+// loaded once for the whole set.
+class DxcSharedIncludeHandler : public IDxcIncludeHandler {
+private:
+  DXC_MICROCOM_REF_FIELD(m_dwRef)
+  CComPtr<IDxcIncludeHandler> m_pInner;
+  std::mutex m_lock;
+  std::unordered_map<std::wstring, std::pair<HRESULT, CComPtr<IDxcBlob>>>
+      m_loaded;
+  std::atomic<unsigned> m_reuseCount;
+
+public:
+  DXC_MICROCOM_ADDREF_RELEASE_IMPL(m_dwRef)
+  DxcSharedIncludeHandler(IDxcIncludeHandler *pInner)
+      : m_dwRef(0), m_pInner(pInner), m_reuseCount(0) {}
+
+  HRESULT STDMETHODCALLTYPE QueryInterface(REFIID iid, void **ppvObject) {
+    return DoBasicQueryInterface<IDxcIncludeHandler>(this, iid, ppvObject);
+  }
+
+  unsigned GetLoadCount() {
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_loaded.size();
+  }
+  unsigned GetReuseCount() const { return m_reuseCount; }
+
+  HRESULT STDMETHODCALLTYPE
+  LoadSource(_In_ LPCWSTR pFilename,
+             _COM_Outptr_result_maybenull_ IDxcBlob **ppIncludeSource) override {
+    *ppIncludeSource = nullptr;
+    try {
+      std::wstring name(pFilename);
+      {
+        std::lock_guard<std::mutex> lock(m_lock);
+        auto it = m_loaded.find(name);
+        if (it != m_loaded.end()) {
+          ++m_reuseCount;
+          *ppIncludeSource = CComPtr<IDxcBlob>(it->second.second).Detach();
+          return it->second.first;
+        }
+      }
+      // Load outside the lock; if another permutation got there first, the
+      // blob it loaded wins so all permutations see the same contents.
+      CComPtr<IDxcBlob> pBlob;
+      HRESULT hr = m_pInner->LoadSource(pFilename, &pBlob);
+      std::lock_guard<std::mutex> lock(m_lock);
+      auto &entry =
+          m_loaded.emplace(std::move(name), std::make_pair(hr, pBlob))
+              .first->second;
+      *ppIncludeSource = CComPtr<IDxcBlob>(entry.second).Detach();
+      return entry.first;
+    }
+    CATCH_CPP_RETURN_HRESULT()
+  }
+};
+
 int DxcContext::Compile(llvm::StringRef path, bool bLibLink) {
   CComPtr<IDxcCompiler> pCompiler;
   CComPtr<IDxcOperationResult> pCompileResult;
@@ -607,8 +674,9 @@ int DxcContext::Compile(llvm::StringRef path, bool bLibLink) {
     }
     IFTARG(pSource->GetBufferSize() >= 4);
 
-    CComPtr<IDxcIncludeHandler> pIncludeHandler;
-    IFT(pLibrary->CreateIncludeHandler(&pIncludeHandler));
+    CComPtr<IDxcIncludeHandler> pIncludeHandler = m_pIncludeHandler;
+    if (!pIncludeHandler)
+      IFT(pLibrary->CreateIncludeHandler(&pIncludeHandler));
 
     // Upgrade profile to 6.0 version from minimum recognized shader model
     llvm::StringRef TargetProfile = m_Opts.TargetProfile;
@@ -755,6 +823,7 @@ public:
       : m_Opts(Opts), m_dxcSupport(dxcSupport) {}
 
   int BatchCompile(bool bMultiThread, bool bLibLink);
+  int PermutationCompile(bool bMultiThread, bool bLibLink, bool bBaseline);
 
 private:
   DxcOpts &m_Opts;
@@ -833,6 +902,149 @@ int DxcBatchContext::BatchCompile(bool bMultiThread, bool bLibLink) {
   return retVal;
 }
 
+// The input lists one base command followed by one line of defines for each
+// permutation, e.g. "-D USE_SHADOWS=1 -D QUALITY=2". Every permutation is
+// compiled as the base command plus its defines. The preprocessor output
+// depends on the defines, so each permutation still parses on its own, but
+// the source includes are loaded once for the whole set and the permutations
+// are spread across threads when bMultiThread is set. With bBaseline, the wall
+// time is compared with independent compiles of the same set.
+int DxcBatchContext::PermutationCompile(bool bMultiThread, bool bLibLink,
+                                        bool bBaseline) {
+  SmallString<128> path(m_Opts.InputFile.begin(), m_Opts.InputFile.end());
+  llvm::sys::path::remove_filename(path);
+
+  CComPtr<IDxcBlobEncoding> pSource;
+  ReadFileIntoBlob(m_dxcSupport, StringRefUtf16(m_Opts.InputFile), &pSource);
+  llvm::StringRef source((char *)pSource->GetBufferPointer(),
+                         pSource->GetBufferSize());
+  llvm::SmallVector<llvm::StringRef, 4> lines;
+  source.split(lines, "\n", /*MaxSplit*/-1, /*KeepEmpty*/false);
+
+  std::vector<std::string> commands;
+  llvm::StringRef baseCommand;
+  for (llvm::StringRef line : lines) {
+    // trim to remove /r if exist.
+    line = line.trim();
+    if (line.empty() || line.startswith("//"))
+      continue;
+    if (baseCommand.empty())
+      baseCommand = line;
+    else
+      commands.emplace_back((baseCommand + " " + line).str());
+  }
+  if (baseCommand.empty())
+    return 0;
+  if (commands.empty())
+    commands.emplace_back(baseCommand.str());
+
+  CComPtr<IDxcLibrary> pLibrary;
+  CComPtr<IDxcIncludeHandler> pFileIncludeHandler;
+  IFT(m_dxcSupport.CreateInstance(CLSID_DxcLibrary, &pLibrary));
+  IFT(pLibrary->CreateIncludeHandler(&pFileIncludeHandler));
+
+  unsigned int threadNum = 1;
+  if (bMultiThread)
+    threadNum = std::max(
+        1u, std::min<unsigned>(std::thread::hardware_concurrency(),
+                               commands.size()));
+
+  // Compiles the whole set on threadNum threads and returns the wall time.
+  // With bShared, the compiles share one include handler that starts empty;
+  // otherwise every compile uses its own include handler.
+  unsigned includeLoads = 0, includeReuses = 0;
+  auto compileSet = [&](bool bShared, std::vector<int> &results,
+                        std::vector<std::string> &errorStrings) {
+    CComPtr<DxcSharedIncludeHandler> pIncludes;
+    if (bShared)
+      pIncludes = new DxcSharedIncludeHandler(pFileIncludeHandler);
+    results.assign(commands.size(), 0);
+    errorStrings.assign(commands.size(), std::string());
+    auto compileOne = [&](unsigned i) {
+      results[i] = ::Compile(commands[i], m_dxcSupport, path.str(), bLibLink,
+                             errorStrings[i], pIncludes);
+    };
+    auto t_start = std::chrono::high_resolution_clock::now();
+    if (threadNum > 1) {
+      std::atomic<unsigned> nextCommand(0);
+      std::vector<std::thread> threads;
+      for (unsigned i = 0; i < threadNum; i++) {
+        threads.emplace_back([&]() {
+          for (unsigned c = nextCommand++; c < commands.size();
+               c = nextCommand++)
+            compileOne(c);
+        });
+      }
+      for (auto &th : threads)
+        th.join();
+    } else {
+      for (unsigned i = 0; i < commands.size(); i++)
+        compileOne(i);
+    }
+    auto t_end = std::chrono::high_resolution_clock::now();
+    if (bShared) {
+      includeLoads = pIncludes->GetLoadCount();
+      includeReuses = pIncludes->GetReuseCount();
+    }
+    return std::chrono::duration<double, std::milli>(t_end - t_start).count();
+  };
+
+  // With bBaseline, the set is also compiled the way a build does without
+  // this mode: independent compiles, each with its own include handler, on the
+  // same number of threads. The two modes run twice in alternating order so
+  // neither one always gets the warm file and OS caches.
+  std::vector<int> results, independentResults;
+  std::vector<std::string> errorStrings, independentErrors;
+  double wallMs = 0, independentMs = 0;
+  if (bBaseline)
+    independentMs += compileSet(false, independentResults, independentErrors);
+  wallMs += compileSet(true, results, errorStrings);
+  if (bBaseline) {
+    wallMs += compileSet(true, results, errorStrings);
+    independentMs += compileSet(false, independentResults, independentErrors);
+  }
+
+  int retVal = 0;
+  for (unsigned i = 0; i < commands.size(); i++) {
+    if (results[i] && 0 == retVal)
+      retVal = results[i];
+    if (errorStrings[i].size()) {
+      fprintf(stderr, "dxc_batch failed : %s", errorStrings[i].c_str());
+      if (0 == retVal)
+        retVal = 1;
+    }
+  }
+
+  fprintf(stderr, "permutations: %u, threads: %u, wall time: %f sec\n",
+          (unsigned)commands.size(), threadNum,
+          wallMs / (bBaseline ? 2 : 1) / 1000);
+  fprintf(stderr, "includes: %u loaded, %u reused\n", includeLoads,
+          includeReuses);
+
+  if (bBaseline) {
+    // A comparison is only meaningful if both modes did the same work.
+    unsigned mismatches = 0;
+    for (unsigned i = 0; i < commands.size(); i++) {
+      if (independentResults[i] != results[i] ||
+          independentErrors[i].empty() != errorStrings[i].empty()) {
+        fprintf(stderr, "dxc_batch failed : permutation %u: independent "
+                        "compile returned %d, shared compile returned %d\n",
+                i, independentResults[i], results[i]);
+        ++mismatches;
+      }
+    }
+    if (mismatches) {
+      if (0 == retVal)
+        retVal = 1;
+    } else {
+      fprintf(stderr,
+              "independent compiles: %f sec, saved against them: %f sec\n",
+              independentMs / 2 / 1000, (independentMs - wallMs) / 2 / 1000);
+    }
+  }
+  return retVal;
+}
+
 int __cdecl wmain(int argc, const wchar_t **argv_) {
   const char *pStage = "Initialization";
   int retVal = 0;
@@ -853,6 +1065,10 @@ int __cdecl wmain(int argc, const wchar_t **argv_) {
     bool bMultiThread = false;
     const char *kLibLinkArg = "-lib-link";
     bool bLibLink = false;
+    const char *kPermutationsArg = "-permutations";
+    bool bPermutations = false;
+    const char *kBaselineArg = "-baseline";
+    bool bBaseline = false;
     // Parse command line options.
     const OptTable *optionTable = getHlslOptTable();
     MainArgs argStrings(argc, argv_);
@@ -865,10 +1081,15 @@ int __cdecl wmain(int argc, const wchar_t **argv_) {
     std::vector<StringRef> refArgs;
     refArgs.reserve(args.size());
     for (auto &arg : args) {
-      if (arg != kMultiThreadArg && arg != kLibLinkArg) {
+      if (arg != kMultiThreadArg && arg != kLibLinkArg &&
+          arg != kPermutationsArg && arg != kBaselineArg &&
         refArgs.emplace_back(arg.c_str());
       } else if (arg == kLibLinkArg) {
         bLibLink = true;
+      } else if (arg == kPermutationsArg) {
+        bPermutations = true;
+      } else if (arg == kBaselineArg) {
+        bBaseline = true;
       } else {
         bMultiThread = true;
       }
@@ -900,7 +1121,7 @@ int __cdecl wmain(int argc, const wchar_t **argv_) {
       std::string helpString;
       llvm::raw_string_ostream helpStream(helpString);
       optionTable->PrintHelp(helpStream, "dxc_batch.exe", "HLSL Compiler", "");
-      helpStream << "multi-thread";
+      helpStream << "multi-thread\nlib-link\npermutations\nbaseline";
       helpStream.flush();
       dxc::WriteUtf8ToConsoleSizeT(helpString.data(), helpString.size());
       return 0;
@@ -922,7 +1143,10 @@ int __cdecl wmain(int argc, const wchar_t **argv_) {
     EnsureEnabled(dxcSupport);
     DxcBatchContext context(dxcOpts, dxcSupport);
     pStage = "BatchCompilation";
-    retVal = context.BatchCompile(bMultiThread, bLibLink);
+    else if (bPermutations)
+      retVal = context.PermutationCompile(bMultiThread, bLibLink, bBaseline);
+    else
+      retVal = context.BatchCompile(bMultiThread, bLibLink);
     {
       auto t_end = std::chrono::high_resolution_clock::now();
       double duration_ms =
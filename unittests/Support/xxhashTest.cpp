@@ -0,0 +1,26 @@
+//===- llvm/unittest/Support/xxhashTest.cpp - xxHash tests ----------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements unit tests for the xxHash64 function.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/xxhash.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+namespace {
+TEST(xxhashTest, Basic) {
+  EXPECT_EQ(0xEF46DB3751D8E999ULL, xxHash64(StringRef()));
+  EXPECT_EQ(0xEF46DB3751D8E999ULL, xxHash64(""));
+  EXPECT_EQ(0xD24EC4F1A98C6E5BULL, xxHash64("a"));
+  EXPECT_EQ(0x44BC2CF5AD770999ULL, xxHash64("abc"));
+}
+}
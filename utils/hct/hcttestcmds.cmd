@@ -353,6 +353,62 @@ call :check_file smoke.opt.bc del
 call :check_file smoke.opt.prn.txt find MODULE-PRINT del
 if %Failed% neq 0 goto :failed
 
+set testname=dxopt -time-passes
+copy passes.txt passes.timed.txt 1>nul
+echo -time-passes >> passes.timed.txt
+call :run dxopt -pf passes.txt -o=smoke.untimed.bc smoke.hl.ll
+call :check_file log find-not "Pass execution timing"
+call :check_file smoke.untimed.bc
+if %Failed% neq 0 goto :failed
+call :run dxopt -pf passes.timed.txt -o=smoke.timed.bc smoke.hl.ll
+call :check_file log find "; Pass execution timing (ms):" find "Total"
+call :check_file smoke.timed.bc
+if %Failed% neq 0 goto :failed
+rem Timing must not change the optimized module.
+fc /b smoke.untimed.bc smoke.timed.bc 1>nul
+if %errorlevel% neq 0 (
+  call :set_failed
+  echo Failed: smoke.timed.bc differs from smoke.untimed.bc
+)
+call :check_file smoke.untimed.bc del
+call :check_file smoke.timed.bc del
+call :check_file passes.timed.txt del
+if %Failed% neq 0 goto :failed
+
+set testname=dxopt -batch
+rem The second input is not a module; it fails without stopping the others,
+rem the results are reported in list order and the exit code is nonzero.
+copy smoke.hl.ll batch1.hl.ll 1>nul
+echo not a module > batch2.bad.ll
+copy smoke.hl.ll batch3.hl.ll 1>nul
+echo batch1.hl.ll> batch.list.txt
+echo batch2.bad.ll>> batch.list.txt
+echo batch3.hl.ll>> batch.list.txt
+call :run-fail dxopt -batch batch.list.txt -j 2 -pf passes.txt -o=.opt.bc
+call :check_file log find "; failed - error code" find "; modules: 3, failed: 1, threads: 2"
+call :check_file batch1.hl.ll.opt.bc del
+call :check_file_not batch2.bad.ll.opt.bc del
+call :check_file batch3.hl.ll.opt.bc del
+if %Failed% neq 0 goto :failed
+set batch_order=
+for /f "tokens=2" %%i in ('findstr /b /e /r /c:"; .*: [0-9.]* ms" %OutputLog%') do set batch_order=!batch_order!%%i
+if not "!batch_order!"=="batch1.hl.ll:batch2.bad.ll:batch3.hl.ll:" (
+  call :set_failed
+  echo Failed: dxopt -batch reported modules out of order: !batch_order!
+)
+for /f "tokens=1 delims=:" %%i in ('findstr /n /b /c:"; batch2.bad.ll:" %OutputLog%') do set /a batch_fail_line=%%i+1
+for /f "tokens=1 delims=:" %%i in ('findstr /n /b /c:"; failed - error code" %OutputLog%') do (
+  if not "%%i"=="!batch_fail_line!" (
+    call :set_failed
+    echo Failed: dxopt -batch reported the failure away from batch2.bad.ll
+  )
+)
+call :check_file batch1.hl.ll del
+call :check_file batch2.bad.ll del
+call :check_file batch3.hl.ll del
+call :check_file batch.list.txt del
+if %Failed% neq 0 goto :failed
+
 set testname=Smoke test for dxc_batch command line
 call :run dxc_batch.exe -lib-link -multi-thread "%testfiles%\batch_cmds2.txt"
 if %Failed% neq 0 goto :failed